@@ -39,6 +39,7 @@ namespace ClassGame {
                     ImGui::Text("Game Over!");
                     ImGui::Text("Winner: %d", gameWinner);
                     if (ImGui::Button("Reset Game")) {
+                        game->stopAI();
                         game->stopGame();
                         game->setUpBoard();
                         gameOver = false;
@@ -76,15 +77,34 @@ namespace ClassGame {
                         ImGui::Text("%s", stateString.substr(y*stride,stride).c_str());
                     }
                     ImGui::Text("Current Board State: %s", game->stateString().c_str());
+                    ImGui::Text("Turn %d of %d", (int)game->currentTurnIndex(), (int)game->turnCount() - 1);
+                    if (ImGui::Button("Undo") && game->currentTurnIndex() > 0) {
+                        game->stopAI();
+                        game->undoTurn();
+                        gameOver = false;
+                        gameWinner = -1;
+                    }
+                    ImGui::SameLine();
+                    if (ImGui::Button("Redo")) {
+                        game->stopAI();
+                        if (game->redoTurn()) {
+                            EndOfTurn();
+                        }
+                    }
+                    game->drawAIStatus();
                 }
                 ImGui::End();
 
                 if(ImGui::Begin("GameWindow", NULL, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoMove))
                 {
                     if (game) {
-                        if (game->gameHasAI() && (game->getCurrentPlayer()->isAIPlayer() || game->_gameOptions.AIvsAI))
+                        if (game->isAIThinking())
+                        {
+                            game->pollAI();
+                        }
+                        else if (game->gameHasAI() && (game->getCurrentPlayer()->isAIPlayer() || game->_gameOptions.AIvsAI))
                         {
-                            game->updateAI();
+                            game->startAI();
                         }
                         game->drawFrame();
                     }
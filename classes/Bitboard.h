@@ -4,6 +4,7 @@
 #include <intrin.h>
 #endif
 
+#include <cstdint>
 #include <iostream>
 
 /* 
@@ -27,6 +28,58 @@ enum ChessPiece
     King
 };
 
+enum ChessColor
+{
+    White,
+    Black
+};
+
+enum BitBoards
+{
+    WHITE_PAWNS,
+    WHITE_KNIGHTS,
+    WHITE_BISHOPS,
+    WHITE_ROOKS,
+    WHITE_QUEENS,
+    WHITE_KING,
+    WHITE_ALL,
+    BLACK_PAWNS,
+    BLACK_KNIGHTS,
+    BLACK_BISHOPS,
+    BLACK_ROOKS,
+    BLACK_QUEENS,
+    BLACK_KING,
+    BLACK_ALL,
+    OCCUPANCY,
+    EMPTY_SQUARES,
+    e_numBitboards
+};
+
+// Maps a color and piece type onto its slot in the BitBoards enum, and back.
+constexpr int PieceBoard(int color, int piece) { return color * BLACK_PAWNS + piece - 1; }
+constexpr int PieceColor(int board) { return board >= BLACK_PAWNS ? Black : White; }
+constexpr int PieceType(int board) { return board % BLACK_PAWNS + 1; }
+
+// Index of the lowest set bit of a non-zero bitboard
+inline int LowestBit(uint64_t bb)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, bb);
+    return (int)index;
+#else
+    return __builtin_ctzll(bb);
+#endif
+}
+
+// Lowest set bit of a non-zero bitboard, cleared from it
+inline int PopLowestBit(uint64_t& bb)
+{
+    int index = LowestBit(bb);
+    bb &= bb - 1;
+    return index;
+}
+
 
 class BitBoard {
     public:
@@ -40,6 +93,15 @@ class BitBoard {
     uint64_t getData() const { return _data; }
     void setData(uint64_t data) { _data = data; }
 
+    // Number of set bits
+    inline int countBits() const {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return (int)__popcnt64(_data);
+#else
+        return __builtin_popcountll(_data);
+#endif
+    }
+
     // Method to loop through each bit in the element and perform an operation on it.
     template <typename Func>
     void forEachBit(Func func) const {
@@ -69,53 +131,90 @@ class BitBoard {
         return *this;
     }
 
-    void printBitBoard() {
-        std::cout << "\n  a b c d e f g h\n";
+    void printBitBoard(std::ostream& out = std::cout) const {
+        out << "\n  a b c d e f g h\n";
         for (int rank = 7; rank >= 0; rank--) {
-            std::cout << (rank + 1) << " ";
+            out << (rank + 1) << " ";
             for (int file = 0; file < 8; file++) {
                 int square = rank * 8 + file;
                 if (_data & (1ULL << square)) {
-                    std::cout << "X ";
+                    out << "X ";
                 } else {
-                    std::cout << ". ";
+                    out << ". ";
                 }
             }
-            std::cout << (rank + 1) << "\n";
-            std::cout << std::flush;
+            out << (rank + 1) << "\n";
         }
-        std::cout << "  a b c d e f g h\n";
-        std::cout << std::flush;
+        out << "  a b c d e f g h\n";
     }
 
 private:
     uint64_t    _data;
 
-    inline int bitScanForward(uint64_t bb) const {
-#if defined(_MSC_VER) && !defined(__clang__)
-        unsigned long index;
-        _BitScanForward64(&index, bb);
-        return index;
-#else
-        return __builtin_ffsll(bb) - 1;
-#endif
-    };
+    inline int bitScanForward(uint64_t bb) const { return LowestBit(bb); };
 
 };
 
-struct BitMove {
-    uint8_t from; // Start square
-    uint8_t to; // Target square
-    uint8_t piece;
-    
-    BitMove(uint8_t from, uint8_t to, uint8_t piece)
-        : from(from), to(to), piece(piece) { }
-        
-    BitMove() : from(0), to(0), piece(0) { }
-    
-    bool operator==(const BitMove& other) const {
-        return from == other.from && 
-               to == other.to && 
-               piece == other.piece;
-    }
-};
\ No newline at end of file
+/*
+    Move flags, laid out so the low bits carry meaning:
+
+    bit 2 (4) --> capture
+    bit 3 (8) --> promotion, with bits 0-1 picking the piece (N, B, R, Q)
+*/
+enum MoveFlags : uint8_t
+{
+    QuietMove = 0,
+    DoublePawnPush = 1,
+    KingCastle = 2,
+    QueenCastle = 3,
+    CaptureMove = 4,
+    EnPassantCapture = 5,
+    KnightPromotion = 8,
+    BishopPromotion = 9,
+    RookPromotion = 10,
+    QueenPromotion = 11,
+    KnightPromotionCapture = 12,
+    BishopPromotionCapture = 13,
+    RookPromotionCapture = 14,
+    QueenPromotionCapture = 15
+};
+
+/*
+    A move packed into 16 bits:
+
+    bits  0-5  --> from square
+    bits  6-11 --> to square
+    bits 12-15 --> MoveFlags
+
+    The moving piece isn't stored; it is whatever sits on "from".
+    The default constructor leaves the bits uninitialized so a MoveList
+    of 256 moves costs nothing to create; use BitMove{} for a null move.
+*/
+class BitMove {
+    public:
+    BitMove() = default;
+    BitMove(int from, int to, int flags = QuietMove)
+        : _data((uint16_t)(from | (to << 6) | (flags << 12))) { }
+
+    int from() const { return _data & 63; }
+    int to() const { return (_data >> 6) & 63; }
+    int flags() const { return _data >> 12; }
+    uint16_t getData() const { return _data; }
+
+    // Rebuild a move from getData(), e.g. out of a hash table entry
+    static BitMove fromData(uint16_t data) { BitMove move; move._data = data; return move; }
+
+    bool isNull() const { return _data == 0; }
+    bool isCapture() const { return flags() & CaptureMove; }
+    bool isPromotion() const { return flags() & KnightPromotion; }
+    bool isCastle() const { return flags() == KingCastle || flags() == QueenCastle; }
+    int promotionPiece() const { return (flags() & 3) + Knight; }
+
+    bool operator==(const BitMove& other) const { return _data == other._data; }
+    bool operator!=(const BitMove& other) const { return _data != other._data; }
+
+private:
+    uint16_t _data;
+};
+
+static_assert(sizeof(BitMove) == 2, "BitMove must stay packed");
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Position.h"
+
+/*
+    A Board is a Position plus a fixed-size undo stack, so search can walk
+    the tree with makeMove() / unmakeMove() and never allocate or copy a
+    whole position per node.
+*/
+
+constexpr int MaxUndoDepth = 1024;
+
+class Board
+{
+public:
+    Board() : _ply(0) { _position.clear(); }
+    explicit Board(const Position& position) : _position(position), _ply(0) { }
+
+    void setPosition(const Position& position)
+    {
+        _position = position;
+        _ply = 0;
+    }
+
+    const Position& position() const { return _position; }
+    int ply() const { return _ply; }
+
+    inline void makeMove(const BitMove& move)
+    {
+        _moveStack[_ply] = move;
+        _position.makeMove(move, _undoStack[_ply]);
+        _ply++;
+    }
+
+    inline void unmakeMove()
+    {
+        _ply--;
+        _position.unmakeMove(_moveStack[_ply], _undoStack[_ply]);
+    }
+
+    // The null move goes on the stack like any other, as BitMove()
+    inline void makeNullMove()
+    {
+        _moveStack[_ply] = BitMove();
+        _position.makeNullMove(_undoStack[_ply]);
+        _ply++;
+    }
+
+    inline void unmakeNullMove()
+    {
+        _ply--;
+        _position.unmakeNullMove(_undoStack[_ply]);
+    }
+
+private:
+    Position _position;
+
+    BitMove  _moveStack[MaxUndoDepth];
+    UndoInfo _undoStack[MaxUndoDepth];
+    int      _ply;
+};
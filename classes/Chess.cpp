@@ -4,613 +4,54 @@
 #include <list>
 
 #include "Bitboard.h"
+#include "Evaluate.h"
+#include "Fen.h"
+#include "Nnue.h"
+#include "TextureCache.h"
 
-Chess::Chess()
-{
-    _grid = new Grid(8, 8);
-
-    PrecomputeMoveData();
-    GenerateBitBoards();
-}
-
-Chess::~Chess()
-{
-    delete _grid;
-}
-
-int Chess::DirectionOffsets[8] = { 8, -8, 1, -1, 7, -7, 9, -9 };
-int Chess::NDirectionOffsets[8] = { 6, 15, 17, 10, -6, -15, -17, -10 };
-int Chess::NumSquaresToEdge[64][8] = {};
-
-MagicEntry ROOK_MAGICS[64];
-MagicEntry BISHOP_MAGICS[64];
-
-BitBoard* ROOK_MOVES[64];
-BitBoard* BISHOP_MOVES[64];
-
-// Bitboards
-
-void Chess::GenerateBitBoards()
-{
-    // For every square . . .
-    for (int i = 0; i < 64; i++)
-    { 
-        // Generate and store every valid knight move in a bitboard.
-        //_pawnBitBoards[i] = GeneratePawnMoveBoard(i);
-
-        // Generate and store every valid knight move in a bitboard.
-        _pawnBitBoards[i] = GeneratePawnMoveBoard(i);
-        _knightBitBoards[i] = GenerateKnightMoveBoard(i);
-        _bishopBitBoards[i] = GenerateBishopMoveBoard(i);
-        _rookBitBoards[i] = GenerateRookMoveBoard(i);
-        _queenBitBoards[i] = GenerateQueenMoveBoard(i);
-        _kingBitBoards[i] = GenerateKingMoveBoard(i);
-        
-    }
-    
-}
-
-BitBoard Chess::GeneratePawnMoveBoard(int square)
-{
-    BitBoard bitBoard = 0ULL;
-    return bitBoard;
-}
-
-BitBoard Chess::GenerateKnightMoveBoard(int square)
-{
-
-    BitBoard bitBoard = 0ULL;
-    int rank = square / 8;
-    int file = square % 8;
-
-    // Move Offset Table
-
-    std::pair<int, int> knightOffsets[] = {
-        { 2, 1 }, { 2, -1 }, { -2, 1 }, { -2, -1 },
-        { 1, 2 }, { 1, -2 }, { -1, 2 }, { -1, -2 }
-    };
-
-    constexpr uint64_t oneBit = 1;
-
-    // For every possible knight move (of 8) . . .
-    for (auto [dr, df] : knightOffsets)
-    {
-        int r = rank + dr, f = file + df; // Target square's rank and file
-
-        // If move is VALID ( regardless of legality* ) . . .
-        if (r >= 0 && r < 8 && f >= 0 && f < 8)
-        {
-            bitBoard |= oneBit << (r * 8 + f); // Set bitBoard
-        }
-    }
-
-    return bitBoard;
-}
-
-BitBoard Chess::GenerateBishopMoveBoard(int square)
-{
-
-    BitBoard mask = 0ULL;
-
-    // Iterate through all four directions
-    for (int dir = 4; dir < 8; dir++)
-    {
-        // Iterate through every square in direction
-        for (int n = 1; n < NumSquaresToEdge[square][dir]; n++)
-        {
-            int to = square + DirectionOffsets[dir] * n;
-            mask |= (1ULL << to);
-        }
-    }
-    return mask;
-}
-
-BitBoard Chess::GenerateRookMoveBoard(int square)
-{
-
-    BitBoard mask = 0ULL;
-
-    // Iterate through all four directions
-    for (int dir = 0; dir < 4; dir++)
-    {
-        // Iterate through every square in direction
-        for (int n = 1; n < NumSquaresToEdge[square][dir]; n++)
-        {
-            int to = square + DirectionOffsets[dir] * n;
-            mask |= (1ULL << to);
-        }
-    }
-    return mask;
-}
-
-BitBoard Chess::GenerateQueenMoveBoard(int square)
-{
-
-    BitBoard bitBoard = 0ULL;
-    return bitBoard;
-}
-
-BitBoard Chess::GenerateKingMoveBoard(int square)
-{
-    BitBoard bitBoard = 0ULL;
-    int rank = square / 8;
-    int file = square % 8;
-
-    // Move Offset Table
-
-    std::pair<int, int> kingOffsets[] = {
-        { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 },
-        { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 }
-    };
-
-    constexpr uint64_t oneBit = 1;
-
-    // For every possible knight move (of 8) . . .
-    for (auto [dr, df] : kingOffsets)
-    {
-        int r = rank + dr, f = file + df; // Target square's rank and file
-
-        // If move is VALID ( regardless of legality* ) . . .
-        if (r >= 0 && r < 8 && f >= 0 && f < 8)
-        {
-            bitBoard |= oneBit << (r * 8 + f); // Set bitBoard
-        }
-    }
-
-    return bitBoard;
-}
-
-BitBoard Chess::RelevantOccupancy(BitBoard mask, int index, int bits)
-{
-    BitBoard occupancy = 0ULL;
-    int bitIndex = 0;
-
-    for (int square = 0; square < 64; square++)
-    {
-        if (mask.getData() & (1ULL << square))
-        {
-            if (index & (1 << bitIndex))
-            {
-                occupancy |= (1ULL << square);
-            }
-
-            bitIndex++;
-        }
-    }
-
-    return occupancy;
-}
-
-BitBoard Chess::GenerateRookAttacks(int square, BitBoard blockers)
-{
-    BitBoard attacks = 0ULL;
-
-    // Iterate through all four directions
-    for (int dir = 0; dir < 4; dir++)
-    {
-        // Iterate through every square in direction
-        for (int n = 1; n < NumSquaresToEdge[square][dir]; n++)
-        {
-            int to = square + DirectionOffsets[dir] * n;
-            attacks |= (1ULL << to);
-            
-            if (blockers.getData() & (1ULL << to))
-            {
-                break;
-            }
-        }
-    }
-    return attacks;
-}
-
-BitBoard Chess::GenerateBishopAttacks(int square, BitBoard blockers)
-{
-    BitBoard attacks = 0ULL;
-
-    // Iterate through all four directions
-    for (int dir = 4; dir < 8; dir++)
-    {
-        // Iterate through every square in direction
-        for (int n = 1; n < NumSquaresToEdge[square][dir]; n++)
-        {
-            int to = square + DirectionOffsets[dir] * n;
-            attacks |= (1ULL << to);
-            
-            if (blockers.getData() & (1ULL << to))
-            {
-                break;
-            }
-        }
-    }
-    return attacks;
-}
-
-// Moves
-
-void Chess::PrecomputeMoveData()
-{
-    std::cout << "Precomputing moves!" << std::endl;
-    std::cout << std::endl;
-
-    for (int file = 0; file < 8; file++)
-    {
-        for (int rank = 0; rank < 8; rank++)
-        {
-            int north = 7 - rank;
-            int south = rank;
-            int east = 7 - file;
-            int west = file;
-
-            int index = rank * 8 + file;
-
-            NumSquaresToEdge[index][0] = north; // Up
-            NumSquaresToEdge[index][1] = south; // Down
-            NumSquaresToEdge[index][2] = east; // Right
-            NumSquaresToEdge[index][3] = west; // Left
-            NumSquaresToEdge[index][4] = std::min(north, west); // Up-Left
-            NumSquaresToEdge[index][5] = std::min(south, east); // Down-Right
-            NumSquaresToEdge[index][6] = std::min(north, east); // Up-Right
-            NumSquaresToEdge[index][7] = std::min(south, west); // Down-Left
-        }
-    }
-}
-
-// Iterate through EVERY bit board to generate EVERY valid / legal move.
-std::vector<BitMove> Chess::GenerateAllMoves()
-{
-    std::cout << "2" << std::endl;
-    std::vector<BitMove> moves;
-    moves.reserve(32);
-    std::string state = stateString();
-    float foo = 0.0f;
-    
-    // Current piece color
-
-    bool whiteToMove = (getCurrentPlayer()->playerNumber() == 0);
-
-    // Define variables for pieces (broadly)
-
-    uint64_t friendlyPieces;
-    uint64_t enemyPieces;
-    uint64_t emptySquares;
-
-    uint64_t pawns;
-    uint64_t knights;
-    uint64_t bishops;
-    uint64_t rooks;
-    uint64_t queen;
-    uint64_t king;
+#include <filesystem>
 
-    uint64_t whitePieces = 0LL;
-    uint64_t whitePawns = 0LL;
-    uint64_t whiteKnights = 0LL;
-    uint64_t whiteBishops = 0LL;
-    uint64_t whiteRooks = 0LL;
-    uint64_t whiteQueen = 0LL;
-    uint64_t whiteKing = 0LL;
+static const char* PieceAtlas = "chess_pieces";
 
-    uint64_t blackPieces = 0LL;
-    uint64_t blackPawns = 0LL;
-    uint64_t blackKnights = 0LL;
-    uint64_t blackBishops = 0LL;
-    uint64_t blackRooks = 0LL;
-    uint64_t blackQueen = 0LL;
-    uint64_t blackKing = 0LL;
-
-
-    for (int i = 0; i < e_numBitboards; i++)
-    {
-        _bitboards[i] = 0;
-    }
-
-    for (int i = 0; i < 64; i++)
-    {
-        if (state[i] == 'P')
-        {
-            whitePawns |= BitZero << i;
-        } else if (state[i] == 'N') {
-            whiteKnights |= BitZero << i;
-        } else if (state[i] == 'B') {
-            whiteBishops |= BitZero << i;
-        } else if (state[i] == 'R') {
-            whiteRooks |= BitZero << i;
-        } else if (state[i] == 'Q') {
-            whiteQueen |= BitZero << i;
-        } else if (state[i] == 'K') {
-            whiteKing |= BitZero << i;
-        }
-
-        if (state[i] == 'p')
-        {
-            blackPawns |= BitZero << i;
-        } else if (state[i] == 'n') {
-            blackKnights |= BitZero << i;
-        } else if (state[i] == 'b') {
-            blackBishops |= BitZero << i;
-        } else if (state[i] == 'r') {
-            blackRooks |= BitZero << i;
-        } else if (state[i] == 'q') {
-            blackQueen |= BitZero << i;
-        } else if (state[i] == 'k') {
-            blackKing |= BitZero << i;
-        }
-    }
-
-    whitePieces = whitePawns | whiteKnights | whiteBishops 
-                | whiteRooks | whiteQueen | whiteKing;
-
-    blackPieces = blackPawns | blackKnights | blackBishops
-                | blackRooks | blackQueen | blackKing;
-
- 
-    friendlyPieces = whiteToMove ? whitePieces : blackPieces;
-    enemyPieces = whiteToMove ? blackPieces : whitePieces;
-    emptySquares = ~(friendlyPieces | enemyPieces);
-
-    pawns = whiteToMove ? whitePawns : blackPawns;
-    knights = whiteToMove ? whiteKnights : blackKnights;
-    bishops = whiteToMove ? whiteBishops : blackBishops;
-    rooks = whiteToMove ? whiteRooks : blackRooks;
-    queen = whiteToMove ? whiteQueen : blackQueen;
-    king = whiteToMove ? whiteKing : blackKing;
-
-    // Generate moves
-    GeneratePawnMoveList(moves, pawns, emptySquares, enemyPieces, getCurrentPlayer()->playerNumber());
-    GenerateKnightMoves(moves, knights, ~friendlyPieces);
-    GenerateKingMoves(moves, king, ~friendlyPieces);
-
-    // Sliding Pieces
-
-    uint64_t sliders = bishops | rooks | queen;
-
-    while (sliders)
-    {
-        int from = __builtin_ctzll(sliders);
-        sliders &= sliders - 1;
-
-        Bit* bit = _grid->getSquareByIndex(from)->bit();
-        GenerateSlidingMoves(moves, from, bit->gameTag());
-    }
-
-    return moves;
-}
-
-void Chess::GenerateSlidingMoves(std::vector<BitMove>& moves, int from, int piece)
+Chess::Chess() : _search(_transpositionTable)
 {
+    _grid = new Grid(8, 8);
+    _promotionPiece = Queen;
 
-    int startDir = (piece == Bishop) ? 4 : 0;
-    int endDir = (piece == Rook) ? 4 : 8;
-
-    // Loop through all eight directions
-
-    for (int dir = startDir; dir < endDir; dir++)
-    {
-        // Loop through every square in given direction
-
-        for (int n = 0; n < NumSquaresToEdge[from][dir]; n++)
-        {
-            int to = from + DirectionOffsets[dir] * (n + 1);;
-            Bit *toPiece = _grid->getSquareByIndex(to)->bit();
-
-            if (toPiece && 
-                toPiece->getOwner()->playerNumber() == 
-                getCurrentPlayer()->playerNumber())
-            {
-                break;
-            }
-
-            moves.emplace_back(from, to, piece);
-
-            if (toPiece &&
-                toPiece->getOwner()->playerNumber() !=
-                getCurrentPlayer()->playerNumber())
-            {
-                break;
-            }
-
-        }
-    }
-}
-
-void Chess::GeneratePawnMoveList(std::vector<BitMove>& moves, BitBoard pawnBoard, uint64_t validSquares, uint64_t enemyPieces, int pieceColor)
-{
-    if (pawnBoard.getData() == 0) { return; }
-
-    // Defined at compile-time
-    constexpr uint64_t NotAFile(0xFEFEFEFEFEFEFEFEULL);
-    constexpr uint64_t NotHFile(0x7F7F7F7F7F7F7F7FULL);
-    constexpr uint64_t Rank3(0x0000000000FF0000ULL);
-    constexpr uint64_t Rank6(0x0000FF0000000000ULL);
-
-    // Calculate single moves
-    BitBoard singleMoves = (pieceColor == 0) ? 
-                            // If white, shift bits
-                           (pawnBoard.getData() << 8) & 
-                            // Remove invalid moves
-                            validSquares : 
-                            // If black, shift bits
-                           (pawnBoard.getData() >> 8) & 
-                            // Remove invalid moves
-                            validSquares;
-
-    BitBoard doubleMoves = (pieceColor == 0) ? 
-                           ((singleMoves.getData() & Rank3) << 8) & 
-                             validSquares : 
-                           ((singleMoves.getData() & Rank6) >> 8) & 
-                             validSquares;
-
-    // Calculate capture moves
-    BitBoard capturesLeft = (pieceColor == 0) ? 
-                             // If white, shift bits
-                            ((pawnBoard.getData() & NotAFile) << 7) & 
-                              enemyPieces :
-                            ((pawnBoard.getData() & NotAFile) >> 9) &
-                              enemyPieces;
-
-    BitBoard capturesRight = (pieceColor == 0) ? 
-                             ((pawnBoard.getData() & NotHFile) << 9) &
-                               enemyPieces :
-                             ((pawnBoard.getData() & NotHFile) >> 7) &
-                               enemyPieces;
-
-    // Calculate pawn move offsets
-    int shift = (pieceColor == 0) ? 8 : -8;
-    int doubleShift = (pieceColor == 0) ? 16 : -16;
-    int captureLeftShift = (pieceColor == 0) ? 7 : -9;
-    int captureRightShift = (pieceColor == 0) ? 9 : -7;
-
-    AddPawnMoves(moves, singleMoves, shift);
-    AddPawnMoves(moves, doubleMoves, doubleShift);
-    AddPawnMoves(moves, capturesLeft, captureLeftShift);
-    AddPawnMoves(moves, capturesRight, captureRightShift);
-
-}
-
-void Chess::AddPawnMoves(std::vector<BitMove>& moves, BitBoard pawnBoard, int shift)
-{
-
-    if (pawnBoard.getData() == 0) { return; }
-
-    pawnBoard.forEachBit([&](int toSquare) {
-        int fromSquare = toSquare - shift;
-        moves.emplace_back(fromSquare, toSquare, Pawn);
-    });
-    /*int startDir = 0;
-    int endDir = 8;
-
-    Bit *fromPiece = _grid->getSquareByIndex(from)->bit();
-
-    // Loop through all eight directions
-
-    for (int dir = startDir; dir < endDir; dir++)
-    {
-
-        // Skip directions a pawn can't move in (white or black)
-
-        if (fromPiece && fromPiece->getOwner()->playerNumber() == 0 && DirectionOffsets[dir] < 7)
-        {
-            continue;
-        }
-
-        if (fromPiece && fromPiece->getOwner()->playerNumber() == 1 && DirectionOffsets[dir] > -7)
-        {
-            continue;
-        }
-
-        // Loop through every square in given direction
-
-        for (int n = 0; n < NumSquaresToEdge[from][dir]; n++)
-        {
-
-            if (fromPiece && 
-                // If dir is vertical . . . 
-                DirectionOffsets[dir] % 2 == 0 )
-            {
-                // If pawn is on starting square . . .
-                if (NumSquaresToEdge[from][dir] >= 6)
-                {
-                    if (n > 1)
-                    {
-                        break;
-                    }
-                }
-                else if (n > 0)
-                {
-                    break;
-                }
-                
-            }
-
-            int to = from + DirectionOffsets[dir] * (n + 1);
-
-            Bit *toPiece = _grid->getSquareByIndex(to)->bit();
-
-            if ( 
-                // If dir is diagonal . . . 
-                abs(DirectionOffsets[dir]) % 2 == 1 )
-            {
-                // If enemy piece on target square . . .
-                if (toPiece && toPiece->getOwner()->playerNumber() != 
-                    getCurrentPlayer()->playerNumber())
-                {
-                    if (n > 0)
-                    {
-                        break;
-                    }
-                }
-                else
-                {
-                    break;
-                }
-            }
+    MoveGenerator::PrecomputeMoveData();
 
-            _moves.emplace_back(from, to, piece);
-        }
-    }*/
-}
+    // All twelve piece images in one texture, kept for the life of the game so
+    // resets and setStateString() never decode a png
+    TextureCache::buildAtlas(PieceAtlas, {
+        "w_pawn.png", "w_knight.png", "w_bishop.png", "w_rook.png", "w_queen.png", "w_king.png",
+        "b_pawn.png", "b_knight.png", "b_bishop.png", "b_rook.png", "b_queen.png", "b_king.png" });
 
-void Chess::GenerateKnightMoves(std::vector<BitMove>& moves, BitBoard knightBoard, uint64_t emptySquares)
-{
-    // While there are still moves . . .
-    knightBoard.forEachBit([&](int fromSquare) {
-        BitBoard moveBoard = BitBoard(_knightBitBoards[fromSquare].getData() & emptySquares);
-
-        moveBoard.printBitBoard();
-        moveBoard.forEachBit([&](int toSquare) {
-            moves.emplace_back(fromSquare, toSquare, Knight);
-        });
-    });
-}
+    // Use the NNUE when a network ships with the resources, else the hand-written evaluation
+    _search.setUseNnue(LoadNetwork((std::filesystem::path("resources") / "nnue.bin").string()));
 
-void Chess::GenerateBishopMoves(std::vector<BitMove>& moves, BitBoard bishopBoard, uint64_t emptySquares)
-{
-    // While there are still moves . . .
-    bishopBoard.forEachBit([&](int fromSquare) {
-        BitBoard moveBoard = BitBoard(_bishopBitBoards[fromSquare].getData() & emptySquares);
-
-        moveBoard.printBitBoard();
-        moveBoard.forEachBit([&](int toSquare) {
-            moves.emplace_back(fromSquare, toSquare, Bishop);
-        });
+    // Runs on the search thread; drawAIStatus() reads it on the render thread
+    _search.setIterationCallback([this](const SearchResult& result) {
+        std::lock_guard<std::mutex> lock(_aiProgressMutex);
+        _aiProgress = result;
     });
 }
 
-void Chess::GenerateRookMoves(std::vector<BitMove>& moves, BitBoard rookBoard, uint64_t emptySquares)
+Chess::~Chess()
 {
-    // While there are still moves . . .
-    rookBoard.forEachBit([&](int fromSquare) {
-        BitBoard moveBoard = BitBoard(_rookBitBoards[fromSquare].getData() & emptySquares);
-
-        moveBoard.printBitBoard();
-        moveBoard.forEachBit([&](int toSquare) {
-            moves.emplace_back(fromSquare, toSquare, Rook);
-        });
-    });
+    stopAI();
+    delete _grid;
+    TextureCache::releaseAtlas(PieceAtlas);
 }
 
-void Chess::GenerateQueenMoves(std::vector<BitMove>& moves, BitBoard queenBoard, uint64_t emptySquares)
-{
-    // While there are still moves . . .
-    queenBoard.forEachBit([&](int fromSquare) {
-        BitBoard moveBoard = BitBoard(_queenBitBoards[fromSquare].getData() & emptySquares);
-
-        moveBoard.printBitBoard();
-        moveBoard.forEachBit([&](int toSquare) {
-            moves.emplace_back(fromSquare, toSquare, Queen);
-        });
-    });
-}
+// Moves
 
-void Chess::GenerateKingMoves(std::vector<BitMove>& moves, BitBoard kingBoard, uint64_t emptySquares)
+// Generate every legal move for the side to move.
+void Chess::GenerateAllMoves(const Position& position, MoveList& moves)
 {
-    // While there are still moves . . .
-    kingBoard.forEachBit([&](int fromSquare) {
-        BitBoard moveBoard = BitBoard(_kingBitBoards[fromSquare].getData() & emptySquares);
+    moves.clear();
 
-        moveBoard.forEachBit([&](int toSquare) {
-            moves.emplace_back(fromSquare, toSquare, King);
-        });
-    });
+    MoveGenerator generator(position);
+    generator.GenerateAllMoves(moves);
 }
 
 // Board
@@ -639,7 +80,7 @@ Bit* Chess::PieceForPlayer(const int playerNumber, ChessPiece piece)
     const char* pieces[] = { "pawn.png", "knight.png", "bishop.png", "rook.png", "queen.png", "king.png" };
 
     Bit* bit = new Bit();
-    // should possibly be cached from player class?
+    // a region of the piece atlas, nothing is loaded here
     const char* pieceName = pieces[piece - 1];
     std::string spritePath = std::string("") + (playerNumber == 0 ? "w_" : "b_") + pieceName;
     bit->LoadTextureFromFile(spritePath.c_str());
@@ -657,84 +98,107 @@ void Chess::setUpBoard()
     _gameOptions.rowY = 8;
 
     _grid->initializeChessSquares(pieceSize, "boardsquare.png");
-    FENtoBoard("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR");
+    FENtoBoard(StartingFEN);
+    _gameKeys.clear();
 
-    startGame();
-    _moves = GenerateAllMoves();
-}
+    // AI plays black, deepening one ply at a time for AIMoveTime or up to AIMAXDepth
+    _gameOptions.AIMAXDepth = MaxPly - 1;
+    _gameOptions.AIDepthSearches = 0;
+    _principalVariation.clear();
+    {
+        std::lock_guard<std::mutex> lock(_aiProgressMutex);
+        _aiProgress = SearchResult{};
+    }
 
-void Chess::FENtoBoard(const std::string& fen) {
-    // convert a FEN string to a board
+    if (gameHasAI()) {
+        setAIPlayer(AI_PLAYER);
+    }
 
-    // FEN is a space delimited string with 6 fields
+    startGame();
 
-    std::stringstream s(fen);
-    std::string row;
+    GenerateAllMoves(_position, _moves);
+}
 
-    char rowDelimiter = '/';
+// Load a full FEN into the engine Position and put the pieces on the board.
+void Chess::FENtoBoard(const std::string& fen)
+{
+    std::string error;
+    if (!ParseFEN(fen, _position, &error))
+    {
+        std::cerr << "Chess: bad FEN \"" << fen << "\": " << error << std::endl;
+        ParseFEN(StartingFEN, _position);
+    }
 
-    int rank = _grid->getHeight() - 1; // Chess Rank (row)
+    syncGridWithPosition();
+}
 
-    while (getline(s, row, rowDelimiter))
+// Put a Bit on every square the engine Position occupies. The Grid only
+// mirrors the Position; it is never read back.
+void Chess::syncGridWithPosition()
+{
+    for (int square = 0; square < 64; square++)
     {
-        int file = 0; // Chess Files (column)
+        ChessSquare* holder = _grid->getSquareByIndex(square);
+        holder->destroyBit();
 
-        for (char c : row)
+        int board = _position.pieceBoardOn(square);
+        if (board == NoPieceBoard)
         {
-            ChessSquare* square = _grid->getSquare(file, rank);
-            ChessPiece piece;
-
-            // I needed help with this one. I found the isdigit function and
-            // then just needed to increase file by the number of squares,
-            // and continue the loop.
-
-            if (std::isdigit(c)) // Skips c squares if empty
-            {
-                file += c - '0';
-                continue;
-            }
-
-            // Realized switch statements were a cleaner solution during
-            // my C++ syntax research while debugging the out-of-range error.
-
-            switch (std::tolower(c)) // Equalizes all piece codes to assign values
-            {
-                case 'r': piece = Rook; break;
-                case 'n': piece = Knight; break;
-                case 'b': piece = Bishop; break;
-                case 'k': piece = King; break;
-                case 'q': piece = Queen; break;
-                case 'p': piece = Pawn; break;
-                default: continue;
-            }
-
-            // I had found I was getting an out-of-range error when I tried
-            // passing the playerNumber, and realized I was passing -1, per
-            // AIPlayer. I simply hard-coded 1 and 0 for the below function. 
+            continue;
+        }
 
-            int pieceOwner = std::isupper(c) ? 0 : 1; // Detects if piece is white / black
+        Bit* bit = PieceForPlayer(PieceColor(board), (ChessPiece)PieceType(board));
+        bit->setPosition(holder->getPosition());
+        holder->setBit(bit);
+    }
+}
 
-            Bit *bit = PieceForPlayer(pieceOwner, piece);
+// History snapshots straight from the Position: one nibble per square (the
+// piece board, shifted past the WHITE_ALL slot, 0 for empty), the move played,
+// and castling rights, en passant square and halfmove clock in turn.state.
+void Chess::snapshotTurn(Turn& turn)
+{
+    turn.board.clear();
+    turn.squares = 64;
+    for (int square = 0; square < 64; square++)
+    {
+        int board = _position.pieceBoardOn(square);
+        if (board != NoPieceBoard)
+        {
+            turn.board.set(square, board < WHITE_ALL ? board + 1 : board);
+        }
+    }
 
-            if (bit != nullptr)
-            {
-                bit->setPosition(square->getPosition());
-                square->setBit(bit);
-            }
+    turn.move = getCurrentTurnNo() ? _lastMovePlayed.getData() : 0;
+    turn.state = _position.castlingRights | (uint32_t)(_position.enPassantSquare + 1) << 4 |
+                 (uint32_t)_position.halfmoveClock << 11;
+}
 
-            //std::cout << "Player: " << bit->getOwner()->playerNumber() << std::endl;
-            //std::cout << "Square: " << pieceNotation(file, rank) << " - (" << file << ", " << rank << ")" << std::endl;
+void Chess::restoreTurn(const Turn& turn)
+{
+    stopAI();
 
-            file++;
+    _position.clear();
+    for (int square = 0; square < 64; square++)
+    {
+        int code = turn.board.get(square);
+        if (code)
+        {
+            _position.addPiece(code <= WHITE_ALL ? code - 1 : code, square);
         }
-
-        rank--;
     }
 
-    // 2: active color (W or B)
-    // 3: castling availability (KQkq or -)
-    // 4: en passant target square (in algebraic notation, or -)
-    // 5: halfmove clock (number of halfmoves since the last capture or pawn advance)
+    _position.castlingRights = turn.state & 15;
+    _position.enPassantSquare = (int8_t)(((turn.state >> 4) & 127) - 1);
+    _position.halfmoveClock = (uint8_t)(turn.state >> 11);
+    _position.sideToMove = turn.number & 1;
+    _position.fullmoveNumber = turn.number / 2 + 1;
+    _position.computeKeys();
+
+    _lastMovePlayed = BitMove::fromData((uint16_t)turn.move);
+    _gameKeys.resize(std::min<size_t>(_gameKeys.size(), turn.number));
+    syncGridWithPosition();
+    GenerateAllMoves(_position, _moves);
 }
 
 bool Chess::actionForEmptyHolder(BitHolder &holder)
@@ -744,6 +208,9 @@ bool Chess::actionForEmptyHolder(BitHolder &holder)
 
 bool Chess::canBitMoveFrom(Bit &bit, BitHolder &src)
 {
+    // nothing moves while the AI is thinking about the position
+    if (isAIThinking()) return false;
+
     // need to implement friendly/unfriendly in bit so for now this hack
     int currentPlayer = getCurrentPlayer()->playerNumber();
     int pieceColor = bit.getOwner()->playerNumber();
@@ -758,10 +225,10 @@ bool Chess::canBitMoveFrom(Bit &bit, BitHolder &src)
         int index = square->getSquareIndex();
         for (auto move : _moves)
         {
-            if (move.from == index)
+            if (move.from() == index)
             {
                 ret = true;
-                auto dest = _grid->getSquareByIndex(move.to);
+                auto dest = _grid->getSquareByIndex(move.to());
                 dest->setHighlighted(true);
             }
         }
@@ -788,10 +255,10 @@ bool Chess::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
 
         for (auto move : _moves)
         {
-            if (move.from == fromIndex && move.to == toIndex)
+            if (move.from() == fromIndex && move.to() == toIndex)
             {
                 ret = true;
-                auto dest = _grid->getSquareByIndex(move.to);
+                auto dest = _grid->getSquareByIndex(move.to());
                 dest->setHighlighted(true);
             }
         }
@@ -821,12 +288,63 @@ void Chess::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
         square->setHighlighted(false);
     });
 
+    // Play the same move on the engine Position (promotions default to a queen)
+    for (auto move : _moves)
+    {
+        if (move.from() == srcSquare->getSquareIndex() && move.to() == dstSquare->getSquareIndex() &&
+            (!move.isPromotion() || move.promotionPiece() == _promotionPiece))
+        {
+            UndoInfo undo;
+            _gameKeys.push_back(_position.zobristKey);
+            _position.makeMove(move, undo);
+            _lastMovePlayed = move;
+            syncGridWithMove(move);
+            break;
+        }
+    }
+
+    // Moves for the next player are needed before endTurn() checks for mate
+    GenerateAllMoves(_position, _moves);
     endTurn();
-    _moves = GenerateAllMoves();
+}
+
+// The drag already moved the piece itself; fix up the squares a special move
+// also changes (castling rook, en passant victim, promoted piece).
+void Chess::syncGridWithMove(const BitMove& move)
+{
+    int color = PieceColor(_position.pieceBoardOn(move.to()));
+
+    if (move.isCastle())
+    {
+        bool kingside = (move.to() & 7) == 6;
+        ChessSquare* rookFrom = _grid->getSquareByIndex(kingside ? move.to() + 1 : move.to() - 2);
+        ChessSquare* rookTo = _grid->getSquareByIndex(kingside ? move.to() - 1 : move.to() + 1);
+
+        Bit* rook = rookFrom->bit();
+        if (rook)
+        {
+            rookTo->setBit(rook);
+            rookFrom->draggedBitTo(rook, rookTo);
+            rook->moveTo(rookTo->getPosition());
+        }
+    }
+    else if (move.flags() == EnPassantCapture)
+    {
+        _grid->getSquareByIndex(color == White ? move.to() - 8 : move.to() + 8)->destroyBit();
+    }
+    else if (move.isPromotion())
+    {
+        ChessSquare* square = _grid->getSquareByIndex(move.to());
+        Bit* bit = PieceForPlayer(color, (ChessPiece)move.promotionPiece());
+        bit->setPosition(square->getPosition());
+        square->setBit(bit);
+    }
 }
 
 void Chess::stopGame()
 {
+    stopAI();
+
     _grid->forEachSquare([](ChessSquare* square, int x, int y) {
         square->destroyBit();
     });
@@ -845,14 +363,19 @@ Player* Chess::ownerAt(int x, int y) const
     return square->bit()->getOwner();
 }
 
+// No legal moves and in check: the side that just moved wins.
 Player* Chess::checkForWinner()
 {
+    if (_moves.empty() && MoveGenerator(_position).inCheck())
+    {
+        return getPlayerAt(_position.sideToMove ^ 1);
+    }
     return nullptr;
 }
 
 bool Chess::checkForDraw()
 {
-    return false;
+    return isStalemate(_position);
 }
 
 std::string Chess::initialStateString()
@@ -888,73 +411,158 @@ void Chess::setStateString(const std::string &s)
 
 // AI Methods
 
+// Principal variation in coordinate notation, "e2e4 e7e5 ..."
+static std::string PVString(const SearchResult& result)
+{
+    std::string line;
+    for (int i = 0; i < result.pvLength; i++)
+    {
+        line += (i ? " " : "") + MoveToUCI(result.pv[i]);
+    }
+    return line;
+}
+
+// Search and play in one go, blocking until the move is made.
 void Chess::updateAI()
 {
-    int alpha = negInfinity;
-    int beta = posInfinity;
+    startAI();
+    if (isAIThinking())
+    {
+        _aiSearch.wait();
+        pollAI();
+    }
+}
+
+// Start searching the current position on a worker thread.
+void Chess::startAI()
+{
+    if (_moves.empty() || isAIThinking())
+    {
+        return;
+    }
 
-    int score = negInfinity;
-    BitMove* bestMove = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_aiProgressMutex);
+        _aiProgress = SearchResult{};
+    }
 
-    std::string state = stateString();
+    SearchLimits limits;
+    limits.depth = getAIMAXDepth();
+    limits.moveTime = AIMoveTime;
 
-    for (auto move : _moves)
+    _search.setGameHistory(_gameKeys);
+    _aiSearch = _search.thinkAsync(_position, limits);
+}
+
+// Play the AI's move once the search is done. Never blocks.
+bool Chess::pollAI()
+{
+    if (!isAIThinking() || _aiSearch.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
     {
-        int srcSquare = move.from;
-        int dstSquare = move.to;
+        return false;
+    }
 
-        char oldDst = state[dstSquare];
-        char srcPce = state[srcSquare];
+    SearchResult result = _aiSearch.get();
+    {
+        std::lock_guard<std::mutex> lock(_aiProgressMutex);
+        _aiProgress = result;
+    }
 
-        // Make temporary move
+    playAIMove(result);
+    return true;
+}
 
-        state[dstSquare] = srcPce;
-        state[srcSquare] = '0';
+// Abandon a running search without playing its move.
+void Chess::stopAI()
+{
+    if (!isAIThinking())
+    {
+        return;
+    }
 
-        int moveVal = -negamax(state, 0, alpha, beta, HUMAN_PLAYER);
+    _search.stop();
+    _aiSearch.get();
+}
 
-        if (moveVal >= score)
-        {
-            score = moveVal;
-            bestMove = &move;
-        }
+void Chess::drawAIStatus()
+{
+    SearchResult progress;
+    {
+        std::lock_guard<std::mutex> lock(_aiProgressMutex);
+        progress = _aiProgress;
+    }
 
-        // Undo Move
+    ImGui::Separator();
+    ImGui::Text("AI: %s", isAIThinking() ? "thinking..." : "waiting");
+    ImGui::Text("Depth: %d", progress.depth);
 
-        state[srcSquare] = srcPce;
-        state[dstSquare] = oldDst;
+    if (std::abs(progress.score) >= MateBound && std::abs(progress.score) <= MateScore)
+    {
+        int plies = MateScore - std::abs(progress.score);
+        ImGui::Text("Score: mate in %d", (progress.score > 0 ? 1 : -1) * (plies + 1) / 2);
+    }
+    else
+    {
+        ImGui::Text("Score: %+.2f", progress.score / 100.0);
     }
 
-    return;
+    ImGui::Text("Nodes: %llu  Hash: %.1f%%  Pawn hash hits: %.0f%%", (unsigned long long)progress.nodes,
+                _transpositionTable.hashfull() / 10.0, progress.pawnHitRate() * 100.0);
+    ImGui::TextWrapped("PV: %s", PVString(progress).c_str());
+    ImGui::TextWrapped("Pruning: %s", PruningSummary(progress.pruning).c_str());
 }
 
-int Chess::negamax(const std::string &state, int depth, int alpha, int beta, int playerNumber)
+// Play the search's move exactly as if it had been dragged: drop the piece
+// on the target square, then let bitMovedFromTo() update the Position, fix
+// up special moves and end the turn.
+void Chess::playAIMove(const SearchResult& result)
 {
-    int bestScore = evaluateAIBoard(state);
-
-    // Check for mate
-    if (isAIWinner() || depth == 2 || abs(bestScore) >= 10000)
+    if (_moves.empty())
     {
-        return bestScore * playerNumber;
+        return;
     }
 
-    // Get legal moves for correctly colored pieces 
+    _gameOptions.AIDepthSearches = result.depth;
+    _gameOptions.score = result.score;
+    _principalVariation = PVString(result);
 
-    int bestEval = -99999;
-    for (int x = 0; x < _moves.size(); x++)
+    // The search always has a move once depth 1 is done; if it somehow
+    // comes back empty, play any legal move rather than lose the turn
+    BitMove move = result.bestMove.isNull() ? _moves[0] : result.bestMove;
+    ChessSquare* srcSquare = _grid->getSquareByIndex(move.from());
+    ChessSquare* dstSquare = _grid->getSquareByIndex(move.to());
+    Bit* bit = srcSquare->bit();
+
+    if (!bit)
     {
+        return;
+    }
 
+    if (dstSquare->bit())
+    {
+        pieceTaken(dstSquare->bit());
     }
 
-    return alpha;
+    if (dstSquare->dropBitAtPoint(bit, dstSquare->getPosition()))
+    {
+        srcSquare->draggedBitTo(bit, dstSquare);
+
+        _promotionPiece = move.isPromotion() ? (ChessPiece)move.promotionPiece() : Queen;
+        bitMovedFromTo(*bit, *srcSquare, *dstSquare);
+        _promotionPiece = Queen;
+    }
 }
 
-int Chess::evaluateAIBoard(const std::string &state)
+int Chess::evaluateAIBoard(const Position& position)
 {
-    return 0;
+    return Evaluate(position);
 }
 
-bool Chess::isAIWinner()
+bool Chess::isStalemate(const Position& position)
 {
-    return false;
-}
+    MoveList moves;
+    MoveGenerator generator(position);
+    generator.GenerateAllMoves(moves);
+
+    return moves.empty() && !generator.inCheck();
+}
\ No newline at end of file
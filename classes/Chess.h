@@ -3,49 +3,21 @@
 #include "Game.h"
 #include "Grid.h"
 #include "Bitboard.h"
+#include "Position.h"
+#include "Board.h"
+#include "MoveGenerator.h"
+#include "ParallelSearch.h"
 
+#include <future>
 #include <list>
+#include <mutex>
 
 constexpr int pieceSize = 80;
-constexpr int negInfinity = -1000000;
-constexpr int posInfinity = +1000000;
 
-constexpr uint64_t BitZero = 1ULL;
+// Milliseconds the AI thinks per move (unless AIMAXDepth is reached first)
+constexpr int64_t AIMoveTime = 1000;
 
-enum BitBoards
-{
-    WHITE_PAWNS,
-    WHITE_KNIGHTS,
-    WHITE_BISHOPS,
-    WHITE_ROOKS,
-    WHITE_QUEENS,
-    WHITE_KING,
-    WHITE_ALL,
-    BLACK_PAWNS,
-    BLACK_KNIGHTS,
-    BLACK_BISHOPS,
-    BLACK_ROOKS,
-    BLACK_QUEENS,
-    BLACK_KING,
-    BLACK_ALL,
-    OCCUPANCY,
-    EMPTY_SQUARES,
-    e_numBitboards
-};
-
-// MAGIC!!
-
-struct MagicEntry {
-    BitBoard mask;
-    uint64_t magic;
-    uint8_t indexBits;
-};
-
-extern MagicEntry ROOK_MAGICS[64];
-extern MagicEntry BISHOP_MAGICS[64];
-
-extern BitBoard* ROOK_MOVES[64];
-extern BitBoard* BISHOP_MOVES[64];
+constexpr uint64_t BitZero = 1ULL;
 
 class Chess : public Game
 {
@@ -73,88 +45,55 @@ public:
 
     // AI Methods
 
-    void    updateAI();
-    int     negamax(const std::string &state, int depth, int alpha, int beta, int playerNumber);
-    int     evaluateAIBoard(const std::string &state);
-    bool    isAIWinner();
-    bool    isStalemate(const std::string &state);
-
-    // BitBoard Methods
-
-    void GenerateBitBoards();
-
-    inline int bitScanForward(uint64_t bb)
-    {
-    #if defined(_MSC_VER) && !defined(__clang__)
-        unsigned long index;
-        _BitScanForward64(&index, bb);
-        return index;
-    #else
-        return __builtin_ffsll(bb) - 1;
-    #endif
-    }
-
-    inline size_t MagicIndex(const MagicEntry& entry, BitBoard blockers)
-    {
-        BitBoard mask = BitBoard(blockers.getData() & entry.mask.getData());
-        uint64_t hash = mask.getData() * entry.magic;
-        return hash >> (64 - entry.indexBits);
-    }
-
-    BitBoard GeneratePawnMoveBoard(int square);
-    BitBoard GenerateKnightMoveBoard(int square);
-    BitBoard GenerateBishopMoveBoard(int square);
-    BitBoard GenerateRookMoveBoard(int square);
-    BitBoard GenerateQueenMoveBoard(int square);
-    BitBoard GenerateKingMoveBoard(int square);
-
-    BitBoard RelevantOccupancy(BitBoard mask, int index, int bits);
-    BitBoard GenerateRookAttacks(int square, BitBoard blockers);
-    BitBoard GenerateBishopAttacks(int square, BitBoard blockers);
-
-    // Move Methods
+    void    updateAI() override;
+    void    startAI() override;
+    bool    pollAI() override;
+    void    stopAI() override;
+    bool    isAIThinking() override { return _aiSearch.valid(); }
+    void    drawAIStatus() override;
+    bool    gameHasAI() override { return true; }
+    int     evaluateAIBoard(const Position& position);
+    bool    isStalemate(const Position& position);
 
-    static void PrecomputeMoveData();
+    // Principal variation of the last AI search, in coordinate notation
+    const std::string& principalVariation() const { return _principalVariation; }
 
-    std::vector<BitMove> GenerateAllMoves();
-    //std::vector<BitMove> GenerateMoves();
-
-    void GeneratePawnMoveList(std::vector<BitMove>& moves, BitBoard pawnBoard, uint64_t friendlyPieces, uint64_t enemyPieces, int pieceColor);
-    void AddPawnMoves(std::vector<BitMove>& moves, BitBoard pawnBoard, int shift);
-
-    void GenerateKnightMoves(std::vector<BitMove>& moves, BitBoard knightBoard, uint64_t friendlyPieces);
-    void GenerateBishopMoves(std::vector<BitMove>& moves, BitBoard bishopBoard, uint64_t friendlyPieces);
-    void GenerateRookMoves(std::vector<BitMove>& moves, BitBoard rookBoard, uint64_t friendlyPieces);
-    void GenerateQueenMoves(std::vector<BitMove>& moves, BitBoard queenBoard, uint64_t friendlyPieces);
-    void GenerateKingMoves(std::vector<BitMove>& moves, BitBoard kingBoard, uint64_t friendlyPieces);
+    // Move Methods
 
-    void GenerateSlidingMoves(std::vector<BitMove>& moves, int from, int piece);
+    void GenerateAllMoves(const Position& position, MoveList& moves);
 
 private:
+    // History snapshots come from the Position, not the Grid
+    void snapshotTurn(Turn& turn) override;
+    void restoreTurn(const Turn& turn) override;
+
     Bit* PieceForPlayer(const int playerNumber, ChessPiece piece);
     Player* ownerAt(int x, int y) const;
     void FENtoBoard(const std::string& fen);
     char pieceNotation(int x, int y) const;
+    void syncGridWithMove(const BitMove& move);
+    void syncGridWithPosition();
+    void playAIMove(const SearchResult& result);
 
     Grid* _grid;
 
-    // BitBoards
+    // Engine Position (the only board search and move generation see)
 
-    BitBoard _bitboards[e_numBitboards];
+    Position _position;
 
-    BitBoard _pawnBitBoards[64];
-    BitBoard _knightBitBoards[64];
-    BitBoard _bishopBitBoards[64];
-    BitBoard _rookBitBoards[64];
-    BitBoard _queenBitBoards[64];
-    BitBoard _kingBitBoards[64];
+    MoveList _moves;
+    BitMove  _lastMovePlayed;
+    std::vector<uint64_t> _gameKeys;    // Position before each move played, for repetition draws
 
-    // Move Data
+    // AI
 
-    static int DirectionOffsets[8];
-    static int NDirectionOffsets[8];
-    static int NumSquaresToEdge[64][8];
+    TranspositionTable  _transpositionTable;    // Must be constructed before _search
+    ParallelSearch      _search;
+    ChessPiece          _promotionPiece;        // Piece bitMovedFromTo() promotes to
+    std::string         _principalVariation;
 
-    std::vector<BitMove> _moves;
+    std::future<SearchResult> _aiSearch;    // Valid while the AI is thinking
+    std::mutex          _aiProgressMutex;
+    SearchResult        _aiProgress;            // Last finished iteration, then the final result
 
 };
\ No newline at end of file
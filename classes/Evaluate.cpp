@@ -0,0 +1,179 @@
+#include "Evaluate.h"
+#include "MoveGenerator.h"
+#include "Trace.h"
+
+#include <algorithm>
+
+// Mobility: bonus per reachable square beyond a typical count, { middlegame, endgame }
+struct MobilityWeight
+{
+    int center;
+    int middlegame;
+    int endgame;
+};
+
+static const MobilityWeight Mobility[7] = {
+    { 0, 0, 0 },        // None
+    { 0, 0, 0 },        // Pawn
+    { 4, 4, 4 },        // Knight
+    { 7, 3, 3 },        // Bishop
+    { 7, 2, 4 },        // Rook
+    { 14, 1, 2 },       // Queen
+    { 0, 0, 0 },        // King
+};
+
+// Squares each color's pieces can move to (not onto its own pieces), scored
+// against the table above. White minus black.
+static void AddMobility(const Position& position, int& middlegame, int& endgame)
+{
+    uint64_t occupancy = position.occupancy();
+
+    for (int color = White; color <= Black; color++)
+    {
+        int sign = (color == White) ? 1 : -1;
+        uint64_t available = ~position.colorPieces(color);
+
+        for (int piece = Knight; piece <= Queen; piece++)
+        {
+            BitBoard pieces = position.pieces(color, piece);
+
+            pieces.forEachBit([&](int square) {
+                uint64_t attacks = (piece == Knight) ? MoveGenerator::KnightAttacks(square)
+                                 : (piece == Bishop) ? BishopAttacks(square, occupancy)
+                                 : (piece == Rook) ? RookAttacks(square, occupancy)
+                                 : QueenAttacks(square, occupancy);
+
+                int count = BitBoard(attacks & available).countBits() - Mobility[piece].center;
+                middlegame += sign * count * Mobility[piece].middlegame;
+                endgame += sign * count * Mobility[piece].endgame;
+            });
+        }
+    }
+}
+
+// Pawn structure, { middlegame, endgame } per pawn
+constexpr int DoubledPenalty[2] = { 10, 20 };
+constexpr int IsolatedPenalty[2] = { 10, 15 };
+constexpr int BackwardPenalty[2] = { 8, 10 };
+
+// Passed pawn bonus by rank, counted from the pawn's own side
+constexpr int PassedBonus[2][8] = {
+    { 0, 5, 10, 15, 30, 50, 80, 0 },
+    { 0, 10, 20, 35, 60, 100, 150, 0 },
+};
+
+constexpr uint64_t FileA = 0x0101010101010101ULL;
+
+static uint64_t AdjacentFiles(int file)
+{
+    return (file > 0 ? FileA << (file - 1) : 0) | (file < 7 ? FileA << (file + 1) : 0);
+}
+
+// Every square strictly in front of square, from color's side, on the given files
+static uint64_t AheadOf(int color, int square, uint64_t files)
+{
+    int rank = square / 8;
+    uint64_t ranks = (color == White) ? (rank < 7 ? ~0ULL << ((rank + 1) * 8) : 0)
+                                      : (rank > 0 ? ~0ULL >> ((8 - rank) * 8) : 0);
+    return files & ranks;
+}
+
+// Score the pawn structure into entry (white minus black) and record the passed pawns.
+static void EvaluatePawns(const Position& position, PawnEntry& entry)
+{
+    int middlegame = 0;
+    int endgame = 0;
+
+    for (int color = White; color <= Black; color++)
+    {
+        int them = color ^ 1;
+        int sign = (color == White) ? 1 : -1;
+        uint64_t ours = position.pieces(color, Pawn);
+        uint64_t theirs = position.pieces(them, Pawn);
+
+        entry.passed[color] = 0;
+
+        BitBoard(ours).forEachBit([&](int square) {
+            int file = square % 8;
+            int rank = (color == White) ? square / 8 : 7 - square / 8;
+            uint64_t fileMask = FileA << file;
+            uint64_t neighbours = AdjacentFiles(file);
+
+            // Doubled: another of our pawns ahead on the same file
+            if (AheadOf(color, square, fileMask) & ours)
+            {
+                middlegame -= sign * DoubledPenalty[0];
+                endgame -= sign * DoubledPenalty[1];
+            }
+
+            // Passed: no enemy pawn ahead on this or a neighbouring file
+            if (!(AheadOf(color, square, fileMask | neighbours) & theirs))
+            {
+                entry.passed[color] |= 1ULL << square;
+                middlegame += sign * PassedBonus[0][rank];
+                endgame += sign * PassedBonus[1][rank];
+            }
+
+            if (!(ours & neighbours))
+            {
+                // Isolated: no friendly pawn on either neighbouring file
+                middlegame -= sign * IsolatedPenalty[0];
+                endgame -= sign * IsolatedPenalty[1];
+            }
+            else
+            {
+                // Backward: every neighbour has moved past it, and an enemy
+                // pawn guards the square in front
+                int stop = (color == White) ? square + 8 : square - 8;
+                uint64_t support = neighbours & ~AheadOf(color, square, neighbours);
+
+                if (!(ours & support) && (MoveGenerator::PawnAttacks(color, stop) & theirs))
+                {
+                    middlegame -= sign * BackwardPenalty[0];
+                    endgame -= sign * BackwardPenalty[1];
+                }
+            }
+        });
+    }
+
+    entry.key = position.pawnKey;
+    entry.middlegame = (int16_t)middlegame;
+    entry.endgame = (int16_t)endgame;
+}
+
+// Material and piece-square terms are running totals kept by the Position,
+// so only mobility looks at the board here. The middlegame and endgame
+// scores are blended by how much material is left.
+static int Blend(const Position& position, const PawnEntry& pawns)
+{
+    int middlegame = position.middlegame[White] - position.middlegame[Black] + pawns.middlegame;
+    int endgame = position.endgame[White] - position.endgame[Black] + pawns.endgame;
+
+    AddMobility(position, middlegame, endgame);
+
+    int phase = std::min((int)position.phase, MaxPhase);
+    int score = (middlegame * phase + endgame * (MaxPhase - phase)) / MaxPhase;
+
+    CHESS_TRACE_LOG(TraceEval, "eval " << score << " (mg " << middlegame << " eg " << endgame << " phase " << phase
+                               << " pawns " << pawns.middlegame << "/" << pawns.endgame << ")");
+
+    return position.sideToMove == White ? score : -score;
+}
+
+int Evaluate(const Position& position, PawnHashTable& pawnTable)
+{
+    bool hit;
+    PawnEntry& pawns = pawnTable.probe(position.pawnKey, hit);
+    if (!hit)
+    {
+        EvaluatePawns(position, pawns);
+    }
+    return Blend(position, pawns);
+}
+
+int Evaluate(const Position& position)
+{
+    PawnEntry pawns;
+    EvaluatePawns(position, pawns);
+    return Blend(position, pawns);
+}
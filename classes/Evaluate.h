@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Position.h"
+#include "PawnHashTable.h"
+
+/*
+    Static evaluation, in centipawns, from the point of view of the side
+    to move (what negamax expects).
+
+    Material and piece-square tables for the middlegame and the endgame,
+    tapered by game phase, plus mobility for the minor and major pieces and
+    pawn structure (doubled, isolated, backward and passed pawns).
+
+    Search passes its pawn hash table so the pawn terms are only computed
+    once per pawn structure; without one they are computed every call.
+*/
+
+int Evaluate(const Position& position, PawnHashTable& pawnTable);
+int Evaluate(const Position& position);
@@ -0,0 +1,410 @@
+#include "Fen.h"
+#include "MoveGenerator.h"
+
+#include <algorithm>
+#include <charconv>
+
+// FEN letter of every piece board ("PNBRQK" then "pnbrqk", with gaps for
+// the WHITE_ALL slot)
+static const char PieceLetters[] = "PNBRQK?pnbrqk";
+
+// Piece board for a FEN letter, or -1
+static int PieceBoardForLetter(char c)
+{
+    switch (c)
+    {
+        case 'P': return WHITE_PAWNS;
+        case 'N': return WHITE_KNIGHTS;
+        case 'B': return WHITE_BISHOPS;
+        case 'R': return WHITE_ROOKS;
+        case 'Q': return WHITE_QUEENS;
+        case 'K': return WHITE_KING;
+        case 'p': return BLACK_PAWNS;
+        case 'n': return BLACK_KNIGHTS;
+        case 'b': return BLACK_BISHOPS;
+        case 'r': return BLACK_ROOKS;
+        case 'q': return BLACK_QUEENS;
+        case 'k': return BLACK_KING;
+        default: return -1;
+    }
+}
+
+static bool Fail(Position& position, std::string* error, std::string message)
+{
+    position.clear();
+    if (error)
+    {
+        *error = std::move(message);
+    }
+    return false;
+}
+
+// Split off the next space separated field of text.
+static std::string_view NextField(std::string_view& text)
+{
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string_view::npos)
+    {
+        text = {};
+        return {};
+    }
+
+    size_t end = text.find_first_of(" \t\r\n", start);
+    std::string_view field = text.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+    text = end == std::string_view::npos ? std::string_view() : text.substr(end);
+    return field;
+}
+
+static bool ParseNumber(std::string_view field, int& value)
+{
+    auto [end, status] = std::from_chars(field.data(), field.data() + field.size(), value);
+    return status == std::errc() && end == field.data() + field.size() && value >= 0;
+}
+
+static bool SetClocks(Position& position, int halfmove, int fullmove)
+{
+    position.halfmoveClock = (uint8_t)std::min(halfmove, 255);
+    position.fullmoveNumber = (uint16_t)std::clamp(fullmove, 1, 65535);
+    return true;
+}
+
+// The placement, side, castling and en passant fields, shared by FEN and EPD.
+static bool ParseBoard(std::string_view& text, Position& position, std::string* error)
+{
+    // The attack tables are needed to test for check
+    static const bool tablesReady = (MoveGenerator::PrecomputeMoveData(), true);
+    (void)tablesReady;
+
+    position.clear();
+
+    std::string_view placement = NextField(text);
+    std::string_view side = NextField(text);
+    std::string_view castling = NextField(text);
+    std::string_view enPassant = NextField(text);
+
+    if (enPassant.empty())
+    {
+        return Fail(position, error, "expected placement, side, castling and en passant fields");
+    }
+
+    // Placement: ranks 8 to 1, files a to h
+    int rank = 7;
+    int file = 0;
+    for (char c : placement)
+    {
+        if (c == '/')
+        {
+            if (file != 8 || rank == 0)
+            {
+                return Fail(position, error, "rank " + std::to_string(rank + 1) + " does not have 8 squares");
+            }
+            rank--;
+            file = 0;
+        }
+        else if (c >= '1' && c <= '8')
+        {
+            file += c - '0';
+            if (file > 8)
+            {
+                return Fail(position, error, "rank " + std::to_string(rank + 1) + " has more than 8 squares");
+            }
+        }
+        else
+        {
+            int board = PieceBoardForLetter(c);
+            if (board < 0)
+            {
+                return Fail(position, error, std::string("bad piece letter '") + c + "'");
+            }
+            if (file > 7)
+            {
+                return Fail(position, error, "rank " + std::to_string(rank + 1) + " has more than 8 squares");
+            }
+            position.addPiece(board, rank * 8 + file);
+            file++;
+        }
+    }
+
+    if (rank != 0 || file != 8)
+    {
+        return Fail(position, error, "placement does not cover 8 ranks of 8 squares");
+    }
+
+    for (int color = White; color <= Black; color++)
+    {
+        if (BitBoard(position.pieces(color, King)).countBits() != 1)
+        {
+            return Fail(position, error, std::string(color == White ? "white" : "black") + " must have exactly one king");
+        }
+    }
+
+    constexpr uint64_t BackRanks = 0xFF000000000000FFULL;
+    if ((position.pieces(White, Pawn) | position.pieces(Black, Pawn)) & BackRanks)
+    {
+        return Fail(position, error, "pawn on the first or last rank");
+    }
+
+    // Side to move
+    if (side == "w")      { position.sideToMove = White; }
+    else if (side == "b") { position.sideToMove = Black; }
+    else
+    {
+        return Fail(position, error, "side to move must be w or b, not '" + std::string(side) + "'");
+    }
+
+    // Castling: "-" or some of KQkq, each backed by a king and rook at home
+    if (castling != "-")
+    {
+        for (char c : castling)
+        {
+            uint8_t right;
+            int color, kingSquare, rookSquare;
+            switch (c)
+            {
+                case 'K': right = WhiteKingside;  color = White; kingSquare = 4;  rookSquare = 7;  break;
+                case 'Q': right = WhiteQueenside; color = White; kingSquare = 4;  rookSquare = 0;  break;
+                case 'k': right = BlackKingside;  color = Black; kingSquare = 60; rookSquare = 63; break;
+                case 'q': right = BlackQueenside; color = Black; kingSquare = 60; rookSquare = 56; break;
+                default:
+                    return Fail(position, error, std::string("bad castling letter '") + c + "'");
+            }
+
+            if (position.castlingRights & right)
+            {
+                return Fail(position, error, std::string("castling right '") + c + "' given twice");
+            }
+            if (position.pieceBoardOn(kingSquare) != PieceBoard(color, King) ||
+                position.pieceBoardOn(rookSquare) != PieceBoard(color, Rook))
+            {
+                return Fail(position, error, std::string("castling right '") + c + "' without king and rook at home");
+            }
+            position.castlingRights |= right;
+        }
+    }
+
+    // En passant: the square a pawn of the side that just moved skipped over
+    if (enPassant != "-")
+    {
+        int them = position.sideToMove ^ 1;
+        int expectedRank = position.sideToMove == White ? 5 : 2;
+
+        if (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h' || enPassant[1] - '1' != expectedRank)
+        {
+            return Fail(position, error, "bad en passant square '" + std::string(enPassant) + "'");
+        }
+
+        int square = expectedRank * 8 + (enPassant[0] - 'a');
+        int pawnSquare = position.sideToMove == White ? square - 8 : square + 8;
+        int fromSquare = position.sideToMove == White ? square + 8 : square - 8;
+
+        if (position.pieceBoardOn(pawnSquare) != PieceBoard(them, Pawn) || !position.isEmpty(square) || !position.isEmpty(fromSquare))
+        {
+            return Fail(position, error, "en passant square '" + std::string(enPassant) + "' without a pawn that just moved two squares");
+        }
+        position.enPassantSquare = (int8_t)square;
+    }
+
+    // The side that just moved can't have left its king attacked
+    int them = position.sideToMove ^ 1;
+    if (MoveGenerator::IsSquareAttacked(position, LowestBit(position.pieces(them, King)), position.sideToMove))
+    {
+        return Fail(position, error, "the side not to move is in check");
+    }
+
+    // addPiece() hashed the pieces; add the state
+    position.zobristKey ^= Zobrist.castling[position.castlingRights];
+    if (position.enPassantSquare != NoSquare)
+    {
+        position.zobristKey ^= Zobrist.enPassant[position.enPassantSquare & 7];
+    }
+    if (position.sideToMove == Black)
+    {
+        position.zobristKey ^= Zobrist.side;
+    }
+
+    return true;
+}
+
+bool ParseFEN(std::string_view fen, Position& position, std::string* error)
+{
+    if (!ParseBoard(fen, position, error))
+    {
+        return false;
+    }
+
+    int halfmove = 0;
+    int fullmove = 1;
+    std::string_view field = NextField(fen);
+
+    if (!field.empty() && !ParseNumber(field, halfmove))
+    {
+        return Fail(position, error, "bad halfmove clock '" + std::string(field) + "'");
+    }
+
+    field = NextField(fen);
+    if (!field.empty() && !ParseNumber(field, fullmove))
+    {
+        return Fail(position, error, "bad fullmove number '" + std::string(field) + "'");
+    }
+
+    field = NextField(fen);
+    if (!field.empty())
+    {
+        return Fail(position, error, "unexpected text after the fullmove number: '" + std::string(field) + "'");
+    }
+
+    return SetClocks(position, halfmove, fullmove);
+}
+
+bool ParseEPD(std::string_view epd, Position& position, std::vector<EpdOperation>* operations, std::string* error)
+{
+    if (!ParseBoard(epd, position, error))
+    {
+        return false;
+    }
+
+    if (operations)
+    {
+        operations->clear();
+    }
+
+    int halfmove = 0;
+    int fullmove = 1;
+
+    // opcode [operands] ; ...  Operands may be quoted and contain ';'
+    size_t i = 0;
+    while (true)
+    {
+        i = epd.find_first_not_of(" \t\r\n", i);
+        if (i == std::string_view::npos)
+        {
+            break;
+        }
+
+        size_t opcodeEnd = epd.find_first_of(" \t\r\n;", i);
+        std::string_view opcode = epd.substr(i, opcodeEnd == std::string_view::npos ? std::string_view::npos : opcodeEnd - i);
+        i = opcodeEnd == std::string_view::npos ? epd.size() : opcodeEnd;
+
+        size_t operandsStart = epd.find_first_not_of(" \t", i);
+        bool quoted = false;
+        size_t end = operandsStart == std::string_view::npos ? epd.size() : operandsStart;
+        while (end < epd.size() && (quoted || epd[end] != ';'))
+        {
+            quoted ^= epd[end] == '"';
+            end++;
+        }
+
+        if (end == epd.size())
+        {
+            return Fail(position, error, "operation '" + std::string(opcode) + "' is not terminated by ';'");
+        }
+
+        std::string_view operands = operandsStart < end ? epd.substr(operandsStart, end - operandsStart) : std::string_view();
+        while (!operands.empty() && (operands.back() == ' ' || operands.back() == '\t'))
+        {
+            operands.remove_suffix(1);
+        }
+        i = end + 1;
+
+        if ((opcode == "hmvc" && !ParseNumber(operands, halfmove)) || (opcode == "fmvn" && !ParseNumber(operands, fullmove)))
+        {
+            return Fail(position, error, "bad " + std::string(opcode) + " operand '" + std::string(operands) + "'");
+        }
+
+        if (operations)
+        {
+            operations->push_back({ std::string(opcode), std::string(operands) });
+        }
+    }
+
+    return SetClocks(position, halfmove, fullmove);
+}
+
+// Placement, side, castling and en passant, shared by FEN and EPD.
+static void WriteBoard(const Position& position, std::string& out)
+{
+    for (int rank = 7; rank >= 0; rank--)
+    {
+        int empty = 0;
+        for (int file = 0; file < 8; file++)
+        {
+            int board = position.pieceBoardOn(rank * 8 + file);
+            if (board == NoPieceBoard)
+            {
+                empty++;
+                continue;
+            }
+            if (empty)
+            {
+                out += (char)('0' + empty);
+                empty = 0;
+            }
+            out += PieceLetters[board];
+        }
+        if (empty)
+        {
+            out += (char)('0' + empty);
+        }
+        if (rank)
+        {
+            out += '/';
+        }
+    }
+
+    out += position.sideToMove == White ? " w " : " b ";
+
+    if (position.castlingRights == NoCastling) { out += '-'; }
+    if (position.castlingRights & WhiteKingside)  { out += 'K'; }
+    if (position.castlingRights & WhiteQueenside) { out += 'Q'; }
+    if (position.castlingRights & BlackKingside)  { out += 'k'; }
+    if (position.castlingRights & BlackQueenside) { out += 'q'; }
+
+    out += ' ';
+    if (position.enPassantSquare == NoSquare)
+    {
+        out += '-';
+    }
+    else
+    {
+        out += (char)('a' + position.enPassantSquare % 8);
+        out += (char)('1' + position.enPassantSquare / 8);
+    }
+}
+
+std::string ToFEN(const Position& position)
+{
+    std::string fen;
+    fen.reserve(96);
+    WriteBoard(position, fen);
+
+    char clocks[16];
+    char* end = clocks;
+    *end++ = ' ';
+    end = std::to_chars(end, clocks + sizeof(clocks), position.halfmoveClock).ptr;
+    *end++ = ' ';
+    end = std::to_chars(end, clocks + sizeof(clocks), position.fullmoveNumber).ptr;
+    fen.append(clocks, end);
+
+    return fen;
+}
+
+std::string ToEPD(const Position& position, const std::vector<EpdOperation>& operations)
+{
+    std::string epd;
+    epd.reserve(128);
+    WriteBoard(position, epd);
+
+    for (const EpdOperation& operation : operations)
+    {
+        epd += ' ';
+        epd += operation.opcode;
+        if (!operation.operands.empty())
+        {
+            epd += ' ';
+            epd += operation.operands;
+        }
+        epd += ';';
+    }
+
+    return epd;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Position.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+    FEN and EPD reading and writing, straight on a Position.
+
+    The reader checks everything a position needs to be searched safely:
+    the board shape, one king per side, no pawns on the back ranks,
+    castling rights that match the kings and rooks, an en passant square
+    behind a pawn that just double-pushed, and the side that just moved
+    not being left in check. On failure it returns false, leaves the
+    Position cleared and, if asked, says what was wrong. Nothing is
+    allocated unless there is an error to report, so corpora of millions
+    of positions load quickly.
+
+    FEN clock fields may be left off (they default to "0 1"). EPD has the
+    four board fields followed by "opcode operands;" operations; hmvc and
+    fmvn set the clocks.
+*/
+
+struct EpdOperation
+{
+    std::string opcode;         // "bm", "id", "c0", ...
+    std::string operands;       // Everything up to the ';', quotes kept
+};
+
+bool ParseFEN(std::string_view fen, Position& position, std::string* error = nullptr);
+bool ParseEPD(std::string_view epd, Position& position, std::vector<EpdOperation>* operations = nullptr,
+              std::string* error = nullptr);
+
+std::string ToFEN(const Position& position);
+std::string ToEPD(const Position& position, const std::vector<EpdOperation>& operations = {});
@@ -21,6 +21,7 @@ Game::Game()
 	_table = nullptr;
 	_winner = nullptr;
 	_lastMove = "";
+	_currentTurn = 0;
 	// everything else
 	_dragBit = nullptr;
 	_dragMoved = false;
@@ -33,10 +34,6 @@ Game::Game()
 
 Game::~Game()
 {
-	for (auto &_turn : _turns)
-	{
-		delete _turn;
-	}
 	_turns.clear();
 	for (auto &_player : _players)
 	{
@@ -67,9 +64,11 @@ void Game::setNumberOfPlayers(unsigned int n)
 	_gameOptions.gameNumber = 0;
 	_gameOptions.numberOfPlayers = n;
 
-	Turn *turn = Turn::initStartOfGame(this);
+	// a long game or self-play session fills this without reallocating
 	_turns.clear();
-	_turns.push_back(turn);
+	_turns.reserve(TURN_HISTORY_RESERVE);
+	_turns.push_back(Turn{});
+	_currentTurn = 0;
 }
 
 void Game::setAIPlayer(unsigned int playerNumber)
@@ -81,28 +80,104 @@ void Game::setAIPlayer(unsigned int playerNumber)
 
 void Game::startGame()
 {
-	std::string startState = stateString();
-	Turn *turn = _turns.at(0);
-	turn->_boardState = startState;
-	turn->_gameNumber = _gameOptions.gameNumber;
 	_gameOptions.currentTurnNo = 0;
+	_turns.resize(1);
+	_currentTurn = 0;
+
+	Turn &turn = _turns.at(0);
+	turn = Turn{};
+	snapshotTurn(turn);
+	turn.number = 0;
+	turn.gameNumber = (int16_t)_gameOptions.gameNumber;
 }
 
 void Game::endTurn()
 {
 	_gameOptions.currentTurnNo++;
-	std::string startState = stateString();
-	Turn *turn = new Turn;
-	turn->_boardState = stateString();
-	turn->_date = (int)_gameOptions.currentTurnNo;
-	turn->_score = _gameOptions.score;
-	turn->_gameNumber = _gameOptions.gameNumber;
+
+	// a new move after an undo replaces everything that came after it
+	_turns.resize(_currentTurn + 1);
+
+	Turn turn{};
+	snapshotTurn(turn);
+	turn.number = (uint16_t)_gameOptions.currentTurnNo;
+	turn.score = _gameOptions.score;
+	turn.gameNumber = (int16_t)_gameOptions.gameNumber;
 	_turns.push_back(turn);
+	_currentTurn = _turns.size() - 1;
 
 	//std::cout << getCurrentPlayer()->playerNumber() << std::endl;
 	ClassGame::EndOfTurn();
 }
 
+bool Game::aiToMoveAt(size_t index)
+{
+	return gameHasAI() && !_gameOptions.AIvsAI && _players.at(_turns[index].number & 1)->isAIPlayer();
+}
+
+bool Game::undoTurn()
+{
+	if (_currentTurn == 0)
+	{
+		return false;
+	}
+	size_t index = _currentTurn - 1;
+	while (index > 0 && aiToMoveAt(index))
+	{
+		index--;
+	}
+	return replayTurn(index);
+}
+
+bool Game::redoTurn()
+{
+	size_t index = _currentTurn + 1;
+	while (index + 1 < _turns.size() && aiToMoveAt(index))
+	{
+		index++;
+	}
+	return replayTurn(index);
+}
+
+bool Game::replayTurn(size_t index)
+{
+	if (index >= _turns.size())
+	{
+		return false;
+	}
+
+	const Turn &turn = _turns[index];
+	_currentTurn = index;
+	_gameOptions.currentTurnNo = turn.number;
+	_gameOptions.score = turn.score;
+	restoreTurn(turn);
+	return true;
+}
+
+void Game::snapshotTurn(Turn &turn)
+{
+	std::string state = stateString();
+	turn.board.clear();
+	turn.squares = (uint8_t)std::min<size_t>(state.size(), BoardSnapshot::MaxSquares);
+	for (int i = 0; i < turn.squares; i++)
+	{
+		if (state[i] >= '0' && state[i] <= '9')
+		{
+			turn.board.set(i, state[i] - '0');
+		}
+	}
+}
+
+void Game::restoreTurn(const Turn &turn)
+{
+	std::string state(turn.squares, '0');
+	for (int i = 0; i < turn.squares; i++)
+	{
+		state[i] = (char)('0' + turn.board.get(i));
+	}
+	setStateString(state);
+}
+
 //
 // scan for mouse is temporarily in the actual game class
 // this will be moved to a higher up class when the squares have a heirarchy
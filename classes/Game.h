@@ -26,6 +26,8 @@
 
 const int AI_PLAYER = 1;
 const int HUMAN_PLAYER = -1;
+// turns reserved up front in the history arena
+const int TURN_HISTORY_RESERVE = 1024;
 
 class GameTable;
 
@@ -95,12 +97,33 @@ public:
 	virtual void stopGame() = 0;
 	virtual bool gameHasAI();
 	virtual void updateAI();
+	// AI turns, split so a slow search can run off the render thread:
+	// startAI() begins thinking, pollAI() is called every frame after that and
+	// plays the move once it is ready (returning true), stopAI() abandons the
+	// search without playing. The defaults just call updateAI().
+	virtual void startAI() { updateAI(); };
+	virtual bool pollAI() { return true; };
+	virtual void stopAI() {};
+	virtual bool isAIThinking() { return false; };
+	// extra lines for the Settings window (search depth, score, ...)
+	virtual void drawAIStatus() {};
 	virtual void pieceTaken(Bit *bit){};
 
 	virtual std::string initialStateString() = 0;
 	virtual std::string stateString() = 0;
 	virtual void setStateString(const std::string &s) = 0;
 
+	// turn history: _turns[0] is the start position, one Turn per ply after it
+	size_t turnCount() const { return _turns.size(); };
+	const Turn &turnAt(size_t index) const { return _turns.at(index); };
+	size_t currentTurnIndex() const { return _currentTurn; };
+	// step through the history (ending a turn after an undo drops the redo tail).
+	// undo and redo skip plies where the AI is to move, so the AI doesn't
+	// start thinking straight away and play over the rest of the history
+	bool undoTurn();
+	bool redoTurn();
+	bool replayTurn(size_t index);
+
 	void setNumberOfPlayers(unsigned int playerCount);
 	void setAIPlayer(unsigned int playerNumber);
 	virtual int getAIDepathSearches() { return _gameOptions.AIDepthSearches; };
@@ -131,13 +154,22 @@ public:
 	Player *_winner;
 
 	std::vector<Player *> _players;
-	std::vector<Turn *> _turns;
+	std::vector<Turn> _turns;		// arena of fixed size turns, never individually allocated
+	size_t _currentTurn;			// index in _turns of the position on the board
 
 	std::string _lastMove;
 
 	GameOptions _gameOptions;
 
 protected:
+	// pack the board into turn.board / turn.squares and fill in turn.move / turn.state.
+	// the default packs the digits of stateString() one square per nibble
+	virtual void snapshotTurn(Turn &turn);
+	// put a snapshot back on the board; the default goes through setStateString()
+	virtual void restoreTurn(const Turn &turn);
+	// true when the AI moves next in _turns[index] (and isn't playing both sides)
+	bool aiToMoveAt(size_t index);
+
 	void mouseDown(ImVec2 &location, Entity *bit);
 	void mouseMoved(ImVec2 &location, Entity *bit);
 	void mouseUp(ImVec2 &location, Entity *bit);
@@ -1,22 +1,23 @@
 #pragma once
 
 #include "ChessSquare.h"
+#include <bit>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <unordered_map>
-#include <functional>
 #include <string>
 
 class Grid
 {
 public:
     Grid(int width, int height);
-    ~Grid();
 
     // Basic access
-    ChessSquare* getSquare(int x, int y);
-    ChessSquare* getSquareByIndex(int index);
-    bool isValid(int x, int y) const;
-    bool isEnabled(int x, int y) const;
+    ChessSquare* getSquare(int x, int y) { return isValid(x, y) ? &_squares[getIndex(x, y)] : nullptr; }
+    ChessSquare* getSquareByIndex(int index) { return index >= 0 && index < _width * _height ? &_squares[index] : nullptr; }
+    bool isValid(int x, int y) const { return x >= 0 && x < _width && y >= 0 && y < _height; }
+    bool isEnabled(int x, int y) const { return isValid(x, y) && enabledAt(getIndex(x, y)); }
     void setEnabled(int x, int y, bool enabled);
 
     // Grid properties
@@ -49,9 +50,31 @@ public:
     std::vector<ChessSquare*> getConnectedSquares(int x, int y);
     bool areConnected(int fromX, int fromY, int toX, int toY);
 
-    // Iterator support
-    void forEachSquare(std::function<void(ChessSquare*, int x, int y)> func);
-    void forEachEnabledSquare(std::function<void(ChessSquare*, int x, int y)> func);
+    // Iterator support: func(ChessSquare*, int x, int y), inlined at the call site
+    template <typename Func>
+    void forEachSquare(Func func)
+    {
+        ChessSquare* square = _squares.get();
+        for (int y = 0; y < _height; y++) {
+            for (int x = 0; x < _width; x++) {
+                func(square++, x, y);
+            }
+        }
+    }
+
+    // Visits the enabled squares in index order, skipping disabled ones a word at a time
+    template <typename Func>
+    void forEachEnabledSquare(Func func)
+    {
+        for (size_t word = 0; word < _enabled.size(); word++) {
+            uint64_t bits = _enabled[word];
+            while (bits) {
+                int index = (int)(word * 64) + std::countr_zero(bits);
+                bits &= bits - 1;
+                func(&_squares[index], index % _width, index / _width);
+            }
+        }
+    }
 
     // Initialize squares with positions and sprites
     void initializeChessSquares(float squareSize, const char* spriteName);
@@ -63,8 +86,11 @@ public:
     void setStateString(const std::string& state);
 
 private:
-    std::vector<std::vector<ChessSquare*>> _squares;
-    std::vector<std::vector<bool>> _enabled;
+    bool enabledAt(int index) const { return (_enabled[index / 64] >> (index % 64)) & 1; }
+
+    // Row-major (index = y * width + x), one allocation for the whole board
+    std::unique_ptr<ChessSquare[]> _squares;
+    std::vector<uint64_t> _enabled;     // Bit per square, by index
     std::unordered_map<int, std::vector<int>> _connections;
     int _width;
     int _height;
@@ -0,0 +1,111 @@
+#include "MagicBitboards.h"
+
+MagicEntry ROOK_MAGICS[64];
+MagicEntry BISHOP_MAGICS[64];
+
+BitBoard* ROOK_MOVES[64];
+BitBoard* BISHOP_MOVES[64];
+
+BitBoard SLIDING_ATTACKS[SlidingAttackTableSize];
+
+// Rank / file steps for each ray: rooks use the first four, bishops the last four.
+static const int RayDirections[8][2] = {
+    { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+    { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 }
+};
+
+// Walk each ray from square, stopping on (and including) the first blocker.
+// With edgeMask set the last square of every ray is dropped instead, which
+// is the relevant-blocker mask for the magic lookup.
+static BitBoard WalkRays(int square, BitBoard blockers, int firstDir, bool edgeMask)
+{
+    BitBoard attacks = 0ULL;
+    int rank = square / 8;
+    int file = square % 8;
+
+    for (int dir = firstDir; dir < firstDir + 4; dir++)
+    {
+        int dr = RayDirections[dir][0];
+        int df = RayDirections[dir][1];
+
+        for (int r = rank + dr, f = file + df; r >= 0 && r < 8 && f >= 0 && f < 8; r += dr, f += df)
+        {
+            if (edgeMask && (r + dr < 0 || r + dr > 7 || f + df < 0 || f + df > 7))
+            {
+                break;
+            }
+
+            int to = r * 8 + f;
+            attacks |= (1ULL << to);
+
+            if (blockers.getData() & (1ULL << to))
+            {
+                break;
+            }
+        }
+    }
+    return attacks;
+}
+
+BitBoard RelevantOccupancy(BitBoard mask, int index, int bits)
+{
+    BitBoard occupancy = 0ULL;
+    int bitIndex = 0;
+
+    mask.forEachBit([&](int square) {
+        if (bitIndex < bits && (index & (1 << bitIndex)))
+        {
+            occupancy |= (1ULL << square);
+        }
+        bitIndex++;
+    });
+
+    return occupancy;
+}
+
+BitBoard GenerateRookAttacks(int square, BitBoard blockers)
+{
+    return WalkRays(square, blockers, 0, false);
+}
+
+BitBoard GenerateBishopAttacks(int square, BitBoard blockers)
+{
+    return WalkRays(square, blockers, 4, false);
+}
+
+// Fill one square's slice of SLIDING_ATTACKS, returning the next free slot.
+static BitBoard* InitSquare(MagicEntry& entry, BitBoard*& moves, BitBoard* slot, int square, uint64_t magic, bool bishop)
+{
+    entry.mask = WalkRays(square, 0ULL, bishop ? 4 : 0, true);
+    entry.magic = magic;
+    entry.indexBits = (uint8_t)entry.mask.countBits();
+    moves = slot;
+
+    int permutations = 1 << entry.indexBits;
+    for (int i = 0; i < permutations; i++)
+    {
+        BitBoard blockers = RelevantOccupancy(entry.mask, i, entry.indexBits);
+        moves[MagicIndex(entry, blockers.getData())] = bishop ? GenerateBishopAttacks(square, blockers)
+                                                              : GenerateRookAttacks(square, blockers);
+    }
+
+    return slot + permutations;
+}
+
+void InitMagicBitboards()
+{
+    static bool initialized = false;
+    if (initialized) { return; }
+    initialized = true;
+
+    BitBoard* slot = SLIDING_ATTACKS;
+
+    for (int square = 0; square < 64; square++)
+    {
+        slot = InitSquare(ROOK_MAGICS[square], ROOK_MOVES[square], slot, square, ROOK_MAGIC_NUMBERS[square], false);
+    }
+    for (int square = 0; square < 64; square++)
+    {
+        slot = InitSquare(BISHOP_MAGICS[square], BISHOP_MOVES[square], slot, square, BISHOP_MAGIC_NUMBERS[square], true);
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Bitboard.h"
+
+#if defined(__BMI2__) && !defined(CHESS_NO_PEXT)
+#include <immintrin.h>
+#define CHESS_USE_PEXT 1
+#endif
+
+/*
+    Magic bitboards for sliding pieces.
+
+    For every square we keep the relevant blocker mask (the ray squares
+    minus the board edge) and a magic multiplier. Multiplying the masked
+    occupancy by the magic and keeping the top indexBits bits gives a
+    perfect index into that square's slice of one contiguous attack table,
+    so a rook / bishop / queen attack lookup is a mask, a multiply, a
+    shift and a load.
+
+    On BMI2 hosts the index is taken with PEXT instead, which packs the
+    masked blockers directly. indexBits is always popcount(mask), so both
+    schemes use exactly the same table layout.
+
+    InitMagicBitboards() fills the table once at startup.
+*/
+
+struct MagicEntry {
+    BitBoard mask;
+    uint64_t magic;
+    uint8_t indexBits;
+};
+
+extern MagicEntry ROOK_MAGICS[64];
+extern MagicEntry BISHOP_MAGICS[64];
+
+// Per-square pointers into SLIDING_ATTACKS
+extern BitBoard* ROOK_MOVES[64];
+extern BitBoard* BISHOP_MOVES[64];
+
+// Sum of 2^popcount(mask) over every square: 102400 rook + 5248 bishop entries
+constexpr int SlidingAttackTableSize = 102400 + 5248;
+extern BitBoard SLIDING_ATTACKS[SlidingAttackTableSize];
+
+// Magic numbers found offline (for shift = 64 - popcount(mask)) and baked in
+constexpr uint64_t ROOK_MAGIC_NUMBERS[64] = {
+    0x208000822810C000ULL, 0x0440001000200040ULL, 0x0100104020010008ULL, 0x0200042200100840ULL,
+    0x4080040080080002ULL, 0x0100080201000400ULL, 0x0400441002010088ULL, 0x6080008000413500ULL,
+    0x0101002040800100ULL, 0x2008802006400880ULL, 0x6002801000200180ULL, 0x0002801001080084ULL,
+    0x1002001008200600ULL, 0x400A000410087200ULL, 0x8000800200010080ULL, 0x0083000040820900ULL,
+    0x1020218000824000ULL, 0x0010484000201000ULL, 0x01C0110041002000ULL, 0x00021D00100100A0ULL,
+    0x4080818008000C00ULL, 0x0820808002000400ULL, 0x0808840001100208ULL, 0x0040520010CC0781ULL,
+    0x4000400080208000ULL, 0x42004000C0201000ULL, 0x0022008600204011ULL, 0x0100100280080080ULL,
+    0x0408008080080401ULL, 0x1106008080040002ULL, 0x4C81000500140200ULL, 0x801001020008904CULL,
+    0x4000400020800080ULL, 0x2008201004400040ULL, 0x8010200080801000ULL, 0x6030008010800805ULL,
+    0x0A20800400800801ULL, 0x0112000402001008ULL, 0x0000480244000190ULL, 0x2480288042001405ULL,
+    0x202180C000228010ULL, 0x0030004020004000ULL, 0xB020011000818020ULL, 0x0800100409010020ULL,
+    0x0C12008820060010ULL, 0x000A001020040400ULL, 0x0044029008040001ULL, 0x4000404400820001ULL,
+    0x0040400080002080ULL, 0x2320400880290100ULL, 0x4100801000200480ULL, 0x010C900105A00900ULL,
+    0x0020800400080080ULL, 0x0000020080040080ULL, 0x1008101228010C00ULL, 0x0008010080440200ULL,
+    0x0426800220110441ULL, 0x0049004020108202ULL, 0x04044090A2000A82ULL, 0x4008208D29001001ULL,
+    0x000A001004200802ULL, 0x0082000410010802ULL, 0x81480201100800C4ULL, 0x0100610084002042ULL
+};
+
+constexpr uint64_t BISHOP_MAGIC_NUMBERS[64] = {
+    0x8020040088104288ULL, 0x0008090C01920102ULL, 0x201000A200520400ULL, 0x80080A0020306001ULL,
+    0x00D403088010A800ULL, 0x0518221110411000ULL, 0x0014808809410200ULL, 0x0010804042202103ULL,
+    0x0401A02092020044ULL, 0x0120080810841040ULL, 0x5040E1150C00800AULL, 0x0000040400880608ULL,
+    0x0216011140080002ULL, 0x8124020104200884ULL, 0x002A843402080405ULL, 0x0020A10120900410ULL,
+    0x0008404048881080ULL, 0x06880660023C0440ULL, 0x0008010400401200ULL, 0x8040804802004000ULL,
+    0x4014026080A01A00ULL, 0x8841001210008400ULL, 0x0121005048088400ULL, 0x00020140C300B840ULL,
+    0x0009408404542800ULL, 0x01940C0820450420ULL, 0x0004010010004C80ULL, 0x0304010048200880ULL,
+    0x0009020024008400ULL, 0x0001230022004100ULL, 0xC201240002008412ULL, 0x0002068008242102ULL,
+    0x4012201220201200ULL, 0x1000C80826041006ULL, 0x0003080804910240ULL, 0x0001380800020A00ULL,
+    0x04B0460020020080ULL, 0x0802008A01210800ULL, 0x20042C0400286108ULL, 0x0004042040008042ULL,
+    0x8000842020000811ULL, 0x2001080884000200ULL, 0x4464402401081004ULL, 0x5000014206202800ULL,
+    0x0040401891040200ULL, 0x300A4C1802000020ULL, 0xD09004080062008EULL, 0x0482420400201306ULL,
+    0x804210D008080080ULL, 0x0012108201100020ULL, 0x0008021201041000ULL, 0x0084100042020000ULL,
+    0x0201301022088214ULL, 0x0800401204030910ULL, 0x202002040800A400ULL, 0x0402040400920502ULL,
+    0x6000808410020282ULL, 0x0110088848080400ULL, 0x4000000842209000ULL, 0x5000090000208810ULL,
+    0x8120058060085040ULL, 0x800000040468020CULL, 0x20000A105010A100ULL, 0x0084103006088018ULL
+};
+
+void InitMagicBitboards();
+
+// Attack masks built by walking each ray (slow, used only to fill the tables)
+BitBoard RelevantOccupancy(BitBoard mask, int index, int bits);
+BitBoard GenerateRookAttacks(int square, BitBoard blockers);
+BitBoard GenerateBishopAttacks(int square, BitBoard blockers);
+
+inline size_t MagicIndex(const MagicEntry& entry, uint64_t blockers)
+{
+#if defined(CHESS_USE_PEXT)
+    return _pext_u64(blockers, entry.mask.getData());
+#else
+    uint64_t hash = (blockers & entry.mask.getData()) * entry.magic;
+    return hash >> (64 - entry.indexBits);
+#endif
+}
+
+inline uint64_t RookAttacks(int square, uint64_t occupancy)
+{
+    return ROOK_MOVES[square][MagicIndex(ROOK_MAGICS[square], occupancy)].getData();
+}
+
+inline uint64_t BishopAttacks(int square, uint64_t occupancy)
+{
+    return BISHOP_MOVES[square][MagicIndex(BISHOP_MAGICS[square], occupancy)].getData();
+}
+
+inline uint64_t QueenAttacks(int square, uint64_t occupancy)
+{
+    return RookAttacks(square, occupancy) | BishopAttacks(square, occupancy);
+}
@@ -0,0 +1,662 @@
+#include "MoveGenerator.h"
+#include "Trace.h"
+
+#include <algorithm>
+
+BitBoard MoveGenerator::_pawnBitBoards[2][64];
+BitBoard MoveGenerator::_knightBitBoards[64];
+BitBoard MoveGenerator::_kingBitBoards[64];
+BitBoard MoveGenerator::_between[64][64];
+BitBoard MoveGenerator::_line[64][64];
+
+// Defined at compile-time
+constexpr uint64_t NotAFile(0xFEFEFEFEFEFEFEFEULL);
+constexpr uint64_t NotHFile(0x7F7F7F7F7F7F7F7FULL);
+constexpr uint64_t Rank1(0x00000000000000FFULL);
+constexpr uint64_t Rank3(0x0000000000FF0000ULL);
+constexpr uint64_t Rank6(0x0000FF0000000000ULL);
+constexpr uint64_t Rank8(0xFF00000000000000ULL);
+
+// Precomputed tables
+
+void MoveGenerator::PrecomputeMoveData()
+{
+    static bool initialized = false;
+    if (initialized) { return; }
+    initialized = true;
+
+    InitMagicBitboards();
+
+    // For every square . . .
+    for (int i = 0; i < 64; i++)
+    {
+        // Generate and store every valid leaper move in a bitboard.
+        _knightBitBoards[i] = GenerateKnightMoveBoard(i);
+        _kingBitBoards[i] = GenerateKingMoveBoard(i);
+
+        uint64_t bit = 1ULL << i;
+        _pawnBitBoards[White][i] = ((bit & NotAFile) << 7) | ((bit & NotHFile) << 9);
+        _pawnBitBoards[Black][i] = ((bit & NotAFile) >> 9) | ((bit & NotHFile) >> 7);
+    }
+
+    // Rays between every pair of aligned squares
+    for (int a = 0; a < 64; a++)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            uint64_t bitA = 1ULL << a;
+            uint64_t bitB = 1ULL << b;
+
+            if (a != b && (RookAttacks(a, 0) & bitB))
+            {
+                _between[a][b] = RookAttacks(a, bitB) & RookAttacks(b, bitA);
+                _line[a][b] = (RookAttacks(a, 0) & RookAttacks(b, 0)) | bitA | bitB;
+            }
+            else if (a != b && (BishopAttacks(a, 0) & bitB))
+            {
+                _between[a][b] = BishopAttacks(a, bitB) & BishopAttacks(b, bitA);
+                _line[a][b] = (BishopAttacks(a, 0) & BishopAttacks(b, 0)) | bitA | bitB;
+            }
+        }
+    }
+}
+
+BitBoard MoveGenerator::GenerateKnightMoveBoard(int square)
+{
+
+    BitBoard bitBoard = 0ULL;
+    int rank = square / 8;
+    int file = square % 8;
+
+    // Move Offset Table
+
+    std::pair<int, int> knightOffsets[] = {
+        { 2, 1 }, { 2, -1 }, { -2, 1 }, { -2, -1 },
+        { 1, 2 }, { 1, -2 }, { -1, 2 }, { -1, -2 }
+    };
+
+    constexpr uint64_t oneBit = 1;
+
+    // For every possible knight move (of 8) . . .
+    for (auto [dr, df] : knightOffsets)
+    {
+        int r = rank + dr, f = file + df; // Target square's rank and file
+
+        // If move is VALID ( regardless of legality* ) . . .
+        if (r >= 0 && r < 8 && f >= 0 && f < 8)
+        {
+            bitBoard |= oneBit << (r * 8 + f); // Set bitBoard
+        }
+    }
+
+    return bitBoard;
+}
+
+BitBoard MoveGenerator::GenerateKingMoveBoard(int square)
+{
+    BitBoard bitBoard = 0ULL;
+    int rank = square / 8;
+    int file = square % 8;
+
+    // Move Offset Table
+
+    std::pair<int, int> kingOffsets[] = {
+        { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 },
+        { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 }
+    };
+
+    constexpr uint64_t oneBit = 1;
+
+    // For every possible king move (of 8) . . .
+    for (auto [dr, df] : kingOffsets)
+    {
+        int r = rank + dr, f = file + df; // Target square's rank and file
+
+        // If move is VALID ( regardless of legality* ) . . .
+        if (r >= 0 && r < 8 && f >= 0 && f < 8)
+        {
+            bitBoard |= oneBit << (r * 8 + f); // Set bitBoard
+        }
+    }
+
+    return bitBoard;
+}
+
+// Attacks
+
+uint64_t MoveGenerator::AttackersTo(const Position& position, int square, uint64_t occupancy)
+{
+    uint64_t rookLike = position.pieces(WHITE_ROOKS) | position.pieces(BLACK_ROOKS)
+                      | position.pieces(WHITE_QUEENS) | position.pieces(BLACK_QUEENS);
+    uint64_t bishopLike = position.pieces(WHITE_BISHOPS) | position.pieces(BLACK_BISHOPS)
+                        | position.pieces(WHITE_QUEENS) | position.pieces(BLACK_QUEENS);
+
+    // A white pawn attacks "square" from where a black pawn on "square" would attack, and vice versa
+    return (PawnAttacks(Black, square) & position.pieces(WHITE_PAWNS))
+         | (PawnAttacks(White, square) & position.pieces(BLACK_PAWNS))
+         | (KnightAttacks(square) & (position.pieces(WHITE_KNIGHTS) | position.pieces(BLACK_KNIGHTS)))
+         | (KingAttacks(square) & (position.pieces(WHITE_KING) | position.pieces(BLACK_KING)))
+         | (RookAttacks(square, occupancy) & rookLike)
+         | (BishopAttacks(square, occupancy) & bishopLike);
+}
+
+bool MoveGenerator::IsSquareAttacked(const Position& position, int square, int byColor)
+{
+    return AttackersTo(position, square, position.occupancy()) & position.colorPieces(byColor);
+}
+
+bool MoveGenerator::InCheck(const Position& position)
+{
+    int us = position.sideToMove;
+    return IsSquareAttacked(position, LowestBit(position.pieces(us, King)), us ^ 1);
+}
+
+bool MoveGenerator::GivesCheck(const Position& position, const BitMove& move)
+{
+    int us = position.sideToMove;
+    int from = move.from();
+    int to = move.to();
+    int king = LowestBit(position.pieces(us ^ 1, King));
+    int piece = move.isPromotion() ? move.promotionPiece() : PieceType(position.pieceBoardOn(from));
+
+    // The board after the move, as far as the sliders can tell
+    uint64_t occupancy = (position.occupancy() & ~(1ULL << from)) | (1ULL << to);
+    if (move.flags() == EnPassantCapture)
+    {
+        occupancy &= ~(1ULL << (us == White ? to - 8 : to + 8));
+    }
+
+    // Direct check by the piece on its new square
+    uint64_t kingBit = 1ULL << king;
+    switch (piece)
+    {
+        case Pawn:   if (PawnAttacks(us, to) & kingBit) { return true; } break;
+        case Knight: if (KnightAttacks(to) & kingBit) { return true; } break;
+        case Bishop: if (BishopAttacks(to, occupancy) & kingBit) { return true; } break;
+        case Rook:   if (RookAttacks(to, occupancy) & kingBit) { return true; } break;
+        case Queen:  if (QueenAttacks(to, occupancy) & kingBit) { return true; } break;
+        default:     break;
+    }
+
+    // Castling checks with the rook
+    uint64_t rookLike = position.pieces(us, Rook) | position.pieces(us, Queen);
+    uint64_t bishopLike = position.pieces(us, Bishop) | position.pieces(us, Queen);
+    if (move.isCastle())
+    {
+        int rookFrom, rookTo;
+        CastlingRookSquares(to, rookFrom, rookTo);
+        occupancy = (occupancy & ~(1ULL << rookFrom)) | (1ULL << rookTo);
+        rookLike = (rookLike & ~(1ULL << rookFrom)) | (1ULL << rookTo);
+    }
+
+    // Discovered check by a slider the move uncovers (the moved piece
+    // itself was handled above)
+    rookLike &= ~(1ULL << from);
+    bishopLike &= ~(1ULL << from);
+    return (RookAttacks(king, occupancy) & rookLike) || (BishopAttacks(king, occupancy) & bishopLike);
+}
+
+// Piece values for exchanges; the king is priced so nothing is ever traded for it
+static const int ExchangeValue[7] = { 0, 100, 320, 330, 500, 900, 20000 };
+
+int MoveGenerator::StaticExchange(const Position& position, const BitMove& move)
+{
+    if (move.isCastle())
+    {
+        return 0;
+    }
+
+    int from = move.from();
+    int to = move.to();
+    int us = position.sideToMove;
+
+    uint64_t rookLike = position.pieces(WHITE_ROOKS) | position.pieces(BLACK_ROOKS)
+                      | position.pieces(WHITE_QUEENS) | position.pieces(BLACK_QUEENS);
+    uint64_t bishopLike = position.pieces(WHITE_BISHOPS) | position.pieces(BLACK_BISHOPS)
+                        | position.pieces(WHITE_QUEENS) | position.pieces(BLACK_QUEENS);
+
+    int attacker = PieceType(position.pieceBoardOn(from));
+    uint64_t occupancy = position.occupancy() ^ (1ULL << from);
+
+    int gain[32];
+    int depth = 0;
+
+    if (move.flags() == EnPassantCapture)
+    {
+        gain[0] = ExchangeValue[Pawn];
+        occupancy ^= 1ULL << (us == White ? to - 8 : to + 8);
+    }
+    else
+    {
+        gain[0] = position.isEmpty(to) ? 0 : ExchangeValue[PieceType(position.pieceBoardOn(to))];
+    }
+
+    if (move.isPromotion())
+    {
+        attacker = move.promotionPiece();
+        gain[0] += ExchangeValue[attacker] - ExchangeValue[Pawn];
+    }
+
+    uint64_t attackers = AttackersTo(position, to, occupancy) & occupancy;
+
+    // Swap list: gain[d] is what the side making capture d has netted if
+    // the sequence stops right after it
+    while (true)
+    {
+        depth++;
+        gain[depth] = ExchangeValue[attacker] - gain[depth - 1];
+
+        // Neither side can come out ahead by carrying on
+        if (std::max(-gain[depth - 1], gain[depth]) < 0)
+        {
+            break;
+        }
+
+        int side = us ^ (depth & 1);
+        uint64_t sideAttackers = attackers & position.colorPieces(side);
+        if (sideAttackers == 0 || depth >= 31)
+        {
+            break;
+        }
+
+        // Least valuable attacker recaptures
+        int piece = Pawn;
+        while (!(sideAttackers & position.pieces(side, piece)))
+        {
+            piece++;
+        }
+
+        uint64_t bit = sideAttackers & position.pieces(side, piece);
+        occupancy ^= bit & (~bit + 1);
+
+        // Sliders behind the piece that just moved join in
+        attackers |= (RookAttacks(to, occupancy) & rookLike) | (BishopAttacks(to, occupancy) & bishopLike);
+        attackers &= occupancy;
+        attacker = piece;
+    }
+
+    while (--depth)
+    {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+    }
+    return gain[0];
+}
+
+// Move generation
+
+MoveGenerator::MoveGenerator(const Position& position)
+    : _position(position)
+{
+    _us = position.sideToMove;
+    _them = _us ^ 1;
+    _friendlyPieces = position.colorPieces(_us);
+    _enemyPieces = position.colorPieces(_them);
+    _occupancy = position.occupancy();
+    _kingSquare = LowestBit(position.pieces(_us, King));
+
+    _checkers = AttackersTo(position, _kingSquare, _occupancy) & _enemyPieces;
+
+    // Enemy sliders lined up on our king with only our own pieces in between
+    uint64_t snipers = (RookAttacks(_kingSquare, _enemyPieces) &
+                            (position.pieces(_them, Rook) | position.pieces(_them, Queen)))
+                     | (BishopAttacks(_kingSquare, _enemyPieces) &
+                            (position.pieces(_them, Bishop) | position.pieces(_them, Queen)));
+
+    _pinned = 0;
+    while (snipers)
+    {
+        int sniper = PopLowestBit(snipers);
+
+        uint64_t blockers = Between(_kingSquare, sniper) & _occupancy;
+        if (blockers && !(blockers & (blockers - 1)))
+        {
+            _pinned |= blockers & _friendlyPieces;
+        }
+    }
+
+    // In single check a move must capture the checker or block its ray
+    _checkMask = ~0ULL;
+    if (_checkers)
+    {
+        int checker = LowestBit(_checkers);
+        _checkMask = Between(_kingSquare, checker) | _checkers;
+    }
+}
+
+// Iterate through EVERY bit board to generate EVERY legal move of the type asked for.
+void MoveGenerator::GenerateMoves(MoveList& moves, MoveGenType type)
+{
+    uint64_t targets = (type == GenCaptures) ? _enemyPieces
+                     : (type == GenQuiets) ? ~_occupancy
+                     : ~_friendlyPieces;
+
+    GenerateKingMoves(moves, targets);
+
+    // Double check: only the king can move
+    if (_checkers & (_checkers - 1))
+    {
+        return;
+    }
+
+    targets &= _checkMask;
+
+    GeneratePawnMoveList(moves, ~_friendlyPieces & _checkMask, type);
+    GenerateKnightMoves(moves, targets);
+    GenerateBishopMoves(moves, targets);
+    GenerateRookMoves(moves, targets);
+    GenerateQueenMoves(moves, targets);
+
+    if (!_checkers && type != GenCaptures)
+    {
+        GenerateCastlingMoves(moves);
+    }
+
+    CHESS_TRACE_LOG(TraceMoveGen, moves.size() << " legal moves, " << BitBoard(_checkers).countBits() << " checkers");
+}
+
+bool MoveGenerator::isLegal(const BitMove& move)
+{
+    int board = _position.pieceBoardOn(move.from());
+    if (move.isNull() || board == NoPieceBoard || PieceColor(board) != _us)
+    {
+        return false;
+    }
+
+    MoveList moves;
+    uint64_t toBit = 1ULL << move.to();
+    uint64_t targets = ~_friendlyPieces & toBit;
+
+    if (PieceType(board) == King)
+    {
+        GenerateKingMoves(moves, targets);
+        if (!_checkers && move.isCastle())
+        {
+            GenerateCastlingMoves(moves);
+        }
+    }
+    else if (!(_checkers & (_checkers - 1)))
+    {
+        targets &= _checkMask;
+
+        switch (PieceType(board))
+        {
+            case Pawn:   GeneratePawnMoveList(moves, targets, GenAll); break;
+            case Knight: GenerateKnightMoves(moves, targets); break;
+            case Bishop: GenerateBishopMoves(moves, targets); break;
+            case Rook:   GenerateRookMoves(moves, targets); break;
+            case Queen:  GenerateQueenMoves(moves, targets); break;
+        }
+    }
+
+    for (const BitMove& legal : moves)
+    {
+        if (legal == move)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Pushes are quiet unless they promote; captures, promotions and en passant
+// make up the capture stage.
+void MoveGenerator::GeneratePawnMoveList(MoveList& moves, uint64_t targets, MoveGenType type)
+{
+    uint64_t pawns = _position.pieces(_us, Pawn);
+    if (pawns == 0) { return; }
+
+    bool quiets = type != GenCaptures;
+    bool captures = type != GenQuiets;
+
+    uint64_t emptySquares = ~_occupancy;
+    uint64_t pinnedPawns = pawns & _pinned;
+    uint64_t freePawns = pawns & ~_pinned;
+    uint64_t promotionRank = (_us == White) ? Rank8 : Rank1;
+
+    // Calculate pawn move offsets
+    int shift = (_us == White) ? 8 : -8;
+    int captureLeftShift = (_us == White) ? 7 : -9;
+    int captureRightShift = (_us == White) ? 9 : -7;
+
+    // Unpinned pawns in bulk, shifting the whole board at once
+    uint64_t singleMoves = (_us == White) ? (freePawns << 8) & emptySquares
+                                          : (freePawns >> 8) & emptySquares;
+
+    uint64_t doubleMoves = (_us == White) ? ((singleMoves & Rank3) << 8) & emptySquares
+                                          : ((singleMoves & Rank6) >> 8) & emptySquares;
+
+    uint64_t capturesLeft = (_us == White) ? ((freePawns & NotAFile) << 7) & _enemyPieces
+                                           : ((freePawns & NotAFile) >> 9) & _enemyPieces;
+
+    uint64_t capturesRight = (_us == White) ? ((freePawns & NotHFile) << 9) & _enemyPieces
+                                            : ((freePawns & NotHFile) >> 7) & _enemyPieces;
+
+    singleMoves &= targets;
+    doubleMoves &= targets;
+    capturesLeft &= targets;
+    capturesRight &= targets;
+
+    if (quiets)
+    {
+        AddPawnMoves(moves, singleMoves & ~promotionRank, shift, QuietMove);
+        AddPawnMoves(moves, doubleMoves, shift * 2, DoublePawnPush);
+    }
+
+    if (captures)
+    {
+        AddPawnMoves(moves, capturesLeft & ~promotionRank, captureLeftShift, CaptureMove);
+        AddPawnMoves(moves, capturesRight & ~promotionRank, captureRightShift, CaptureMove);
+
+        AddPromotions(moves, singleMoves & promotionRank, shift, false);
+        AddPromotions(moves, capturesLeft & promotionRank, captureLeftShift, true);
+        AddPromotions(moves, capturesRight & promotionRank, captureRightShift, true);
+    }
+
+    // Pinned pawns one at a time, restricted to their pin ray
+    while (pinnedPawns)
+    {
+        int from = PopLowestBit(pinnedPawns);
+
+        uint64_t bit = 1ULL << from;
+        uint64_t pinMask = Line(_kingSquare, from) & targets;
+
+        uint64_t push = ((_us == White) ? bit << 8 : bit >> 8) & emptySquares;
+        uint64_t doublePush = ((_us == White) ? (push & Rank3) << 8 : (push & Rank6) >> 8) & emptySquares;
+        uint64_t pawnCaptures = PawnAttacks(_us, from) & _enemyPieces;
+
+        BitBoard moveBoard = (push | doublePush | pawnCaptures) & pinMask;
+
+        moveBoard.forEachBit([&](int toSquare) {
+            uint64_t toBit = 1ULL << toSquare;
+            bool capture = pawnCaptures & toBit;
+
+            if (toBit & promotionRank)
+            {
+                if (captures)
+                {
+                    AddPromotions(moves, toBit, toSquare - from, capture);
+                }
+            }
+            else if (capture ? captures : quiets)
+            {
+                uint8_t flags = capture ? CaptureMove : (doublePush & toBit) ? DoublePawnPush : QuietMove;
+                moves.add(from, toSquare, flags);
+            }
+        });
+    }
+
+    if (captures)
+    {
+        GenerateEnPassant(moves);
+    }
+}
+
+void MoveGenerator::AddPawnMoves(MoveList& moves, uint64_t toBoard, int shift, uint8_t flags)
+{
+    while (toBoard)
+    {
+        int toSquare = PopLowestBit(toBoard);
+        moves.add(toSquare - shift, toSquare, flags);
+    }
+}
+
+void MoveGenerator::AddPromotions(MoveList& moves, uint64_t toBoard, int shift, bool capture)
+{
+    uint8_t base = capture ? KnightPromotionCapture : KnightPromotion;
+
+    while (toBoard)
+    {
+        int toSquare = PopLowestBit(toBoard);
+
+        // Queen first, it is nearly always the one we want
+        for (int i = 3; i >= 0; i--)
+        {
+            moves.add(toSquare - shift, toSquare, base + i);
+        }
+    }
+}
+
+void MoveGenerator::GenerateEnPassant(MoveList& moves)
+{
+    int epSquare = _position.enPassantSquare;
+    if (epSquare == NoSquare) { return; }
+
+    int captureSquare = (_us == White) ? epSquare - 8 : epSquare + 8;
+    uint64_t captureBit = 1ULL << captureSquare;
+
+    // In check, the only checker en passant can remove is the pawn itself
+    if (_checkers && !(_checkers & captureBit) && !(_checkMask & (1ULL << epSquare)))
+    {
+        return;
+    }
+
+    uint64_t attackers = PawnAttacks(_them, epSquare) & _position.pieces(_us, Pawn);
+    uint64_t enemyRooks = _position.pieces(_them, Rook) | _position.pieces(_them, Queen);
+    uint64_t enemyBishops = _position.pieces(_them, Bishop) | _position.pieces(_them, Queen);
+
+    while (attackers)
+    {
+        int from = PopLowestBit(attackers);
+
+        // Lift both pawns off the board and see whether a slider now hits the king.
+        // This also catches the rank pin that a normal pin mask misses.
+        uint64_t occupancy = (_occupancy ^ (1ULL << from) ^ captureBit) | (1ULL << epSquare);
+
+        if ((RookAttacks(_kingSquare, occupancy) & enemyRooks) ||
+            (BishopAttacks(_kingSquare, occupancy) & enemyBishops & ~captureBit))
+        {
+            continue;
+        }
+
+        moves.add(from, epSquare, EnPassantCapture);
+    }
+}
+
+void MoveGenerator::GenerateKnightMoves(MoveList& moves, uint64_t targets)
+{
+    // Pinned knights can never move
+    BitBoard knightBoard = _position.pieces(_us, Knight) & ~_pinned;
+
+    // While there are still moves . . .
+    knightBoard.forEachBit([&](int fromSquare) {
+        BitBoard moveBoard = BitBoard(KnightAttacks(fromSquare) & targets);
+        CHESS_TRACE_BITBOARD(TraceMoveGen, "knight " << SquareName(fromSquare), moveBoard);
+
+        moveBoard.forEachBit([&](int toSquare) {
+            uint8_t flags = (_enemyPieces & (1ULL << toSquare)) ? CaptureMove : QuietMove;
+            moves.add(fromSquare, toSquare, flags);
+        });
+    });
+}
+
+void MoveGenerator::GenerateBishopMoves(MoveList& moves, uint64_t targets)
+{
+    BitBoard bishopBoard = _position.pieces(_us, Bishop);
+
+    // While there are still moves . . .
+    bishopBoard.forEachBit([&](int fromSquare) {
+        BitBoard moveBoard = BitBoard(BishopAttacks(fromSquare, _occupancy) & targets & PinMask(fromSquare));
+        CHESS_TRACE_BITBOARD(TraceMoveGen, "bishop " << SquareName(fromSquare), moveBoard);
+
+        moveBoard.forEachBit([&](int toSquare) {
+            uint8_t flags = (_enemyPieces & (1ULL << toSquare)) ? CaptureMove : QuietMove;
+            moves.add(fromSquare, toSquare, flags);
+        });
+    });
+}
+
+void MoveGenerator::GenerateRookMoves(MoveList& moves, uint64_t targets)
+{
+    BitBoard rookBoard = _position.pieces(_us, Rook);
+
+    // While there are still moves . . .
+    rookBoard.forEachBit([&](int fromSquare) {
+        BitBoard moveBoard = BitBoard(RookAttacks(fromSquare, _occupancy) & targets & PinMask(fromSquare));
+        CHESS_TRACE_BITBOARD(TraceMoveGen, "rook " << SquareName(fromSquare), moveBoard);
+
+        moveBoard.forEachBit([&](int toSquare) {
+            uint8_t flags = (_enemyPieces & (1ULL << toSquare)) ? CaptureMove : QuietMove;
+            moves.add(fromSquare, toSquare, flags);
+        });
+    });
+}
+
+void MoveGenerator::GenerateQueenMoves(MoveList& moves, uint64_t targets)
+{
+    BitBoard queenBoard = _position.pieces(_us, Queen);
+
+    // While there are still moves . . .
+    queenBoard.forEachBit([&](int fromSquare) {
+        BitBoard moveBoard = BitBoard(QueenAttacks(fromSquare, _occupancy) & targets & PinMask(fromSquare));
+        CHESS_TRACE_BITBOARD(TraceMoveGen, "queen " << SquareName(fromSquare), moveBoard);
+
+        moveBoard.forEachBit([&](int toSquare) {
+            uint8_t flags = (_enemyPieces & (1ULL << toSquare)) ? CaptureMove : QuietMove;
+            moves.add(fromSquare, toSquare, flags);
+        });
+    });
+}
+
+void MoveGenerator::GenerateKingMoves(MoveList& moves, uint64_t targets)
+{
+    BitBoard moveBoard = BitBoard(KingAttacks(_kingSquare) & targets);
+
+    // The king can't hide behind itself from a slider, so take it off the board first
+    uint64_t occupancy = _occupancy ^ (1ULL << _kingSquare);
+
+    moveBoard.forEachBit([&](int toSquare) {
+        if (AttackersTo(_position, toSquare, occupancy) & _enemyPieces)
+        {
+            return;
+        }
+        uint8_t flags = (_enemyPieces & (1ULL << toSquare)) ? CaptureMove : QuietMove;
+        moves.add(_kingSquare, toSquare, flags);
+    });
+}
+
+void MoveGenerator::GenerateCastlingMoves(MoveList& moves)
+{
+    uint8_t rights = _position.castlingRights;
+    uint8_t kingside = (_us == White) ? WhiteKingside : BlackKingside;
+    uint8_t queenside = (_us == White) ? WhiteQueenside : BlackQueenside;
+    int home = (_us == White) ? 4 : 60;
+
+    if (_kingSquare != home) { return; }
+
+    // King and rook squares must be clear, and the king may not pass through an attacked square
+    if ((rights & kingside) &&
+        !(_occupancy & ((1ULL << (home + 1)) | (1ULL << (home + 2)))) &&
+        !IsSquareAttacked(_position, home + 1, _them) &&
+        !IsSquareAttacked(_position, home + 2, _them))
+    {
+        moves.add(home, home + 2, KingCastle);
+    }
+
+    if ((rights & queenside) &&
+        !(_occupancy & ((1ULL << (home - 1)) | (1ULL << (home - 2)) | (1ULL << (home - 3)))) &&
+        !IsSquareAttacked(_position, home - 1, _them) &&
+        !IsSquareAttacked(_position, home - 2, _them))
+    {
+        moves.add(home, home - 2, QueenCastle);
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Bitboard.h"
+#include "Position.h"
+#include "MagicBitboards.h"
+#include "MoveList.h"
+
+// Which moves to generate. Captures covers every capture, en passant and
+// every promotion; Quiets is the rest, so the two together are All.
+enum MoveGenType
+{
+    GenAll,
+    GenCaptures,
+    GenQuiets
+};
+
+/*
+    Fully legal move generation on a Position.
+
+    The constructor works out, once per node, which enemy pieces give
+    check and which of our pieces are pinned (and along which ray).
+    Every generator then masks its targets with that information, so
+    only legal moves are ever emitted: no make / test / unmake filter.
+
+    An empty move list means mate (inCheck()) or stalemate.
+*/
+
+class MoveGenerator
+{
+public:
+    explicit MoveGenerator(const Position& position);
+
+    // Fill the leaper, between and line tables (and the magic tables).
+    static void PrecomputeMoveData();
+
+    void GenerateAllMoves(MoveList& moves) { GenerateMoves(moves, GenAll); }
+    void GenerateMoves(MoveList& moves, MoveGenType type);
+
+    // Whether a move from elsewhere (hash table, killer slot) is legal here.
+    // Only the moving piece's moves to that square are generated.
+    bool isLegal(const BitMove& move);
+
+    bool inCheck() const { return _checkers != 0; }
+    uint64_t checkers() const { return _checkers; }
+    uint64_t pinned() const { return _pinned; }
+
+    // All pieces (of both colors) attacking square, given an occupancy.
+    static uint64_t AttackersTo(const Position& position, int square, uint64_t occupancy);
+    static bool IsSquareAttacked(const Position& position, int square, int byColor);
+    // Whether the side to move is in check, without building a generator.
+    static bool InCheck(const Position& position);
+    // Whether a legal move would check the opponent, without making it:
+    // the moved piece attacks the king, or it uncovers a slider that does.
+    static bool GivesCheck(const Position& position, const BitMove& move);
+
+    // Static exchange evaluation: the material the side to move comes out
+    // with, in centipawns, if both sides keep recapturing on move.to() with
+    // their least valuable piece and either may stop when it pays to.
+    static int StaticExchange(const Position& position, const BitMove& move);
+
+    static uint64_t KnightAttacks(int square) { return _knightBitBoards[square].getData(); }
+    static uint64_t KingAttacks(int square) { return _kingBitBoards[square].getData(); }
+    static uint64_t PawnAttacks(int color, int square) { return _pawnBitBoards[color][square].getData(); }
+
+    // Squares strictly between a and b on a shared rank, file or diagonal (else 0).
+    static uint64_t Between(int a, int b) { return _between[a][b].getData(); }
+    // The full line through a and b (else 0).
+    static uint64_t Line(int a, int b) { return _line[a][b].getData(); }
+
+private:
+    void GeneratePawnMoveList(MoveList& moves, uint64_t targets, MoveGenType type);
+    void AddPawnMoves(MoveList& moves, uint64_t toBoard, int shift, uint8_t flags);
+    void AddPromotions(MoveList& moves, uint64_t toBoard, int shift, bool capture);
+    void GenerateEnPassant(MoveList& moves);
+
+    void GenerateKnightMoves(MoveList& moves, uint64_t targets);
+    void GenerateBishopMoves(MoveList& moves, uint64_t targets);
+    void GenerateRookMoves(MoveList& moves, uint64_t targets);
+    void GenerateQueenMoves(MoveList& moves, uint64_t targets);
+    void GenerateKingMoves(MoveList& moves, uint64_t targets);
+    void GenerateCastlingMoves(MoveList& moves);
+
+    // Targets a piece on "from" may use, after applying its pin ray.
+    inline uint64_t PinMask(int from) const
+    {
+        return (_pinned & (1ULL << from)) ? Line(_kingSquare, from) : ~0ULL;
+    }
+
+    static BitBoard GenerateKnightMoveBoard(int square);
+    static BitBoard GenerateKingMoveBoard(int square);
+
+    const Position& _position;
+
+    int      _us;
+    int      _them;
+    int      _kingSquare;
+    uint64_t _friendlyPieces;
+    uint64_t _enemyPieces;
+    uint64_t _occupancy;
+    uint64_t _checkers;
+    uint64_t _pinned;
+    uint64_t _checkMask;        // Squares a non-king move must land on (block or capture)
+
+    static BitBoard _pawnBitBoards[2][64];
+    static BitBoard _knightBitBoards[64];
+    static BitBoard _kingBitBoards[64];
+    static BitBoard _between[64][64];
+    static BitBoard _line[64][64];
+};
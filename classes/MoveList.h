@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Bitboard.h"
+
+/*
+    A fixed-capacity list of moves that lives on the stack.
+
+    No legal chess position has more than 218 moves, so 256 slots never
+    overflow and move generation never touches the heap.
+*/
+
+constexpr int MaxMoves = 256;
+
+class MoveList
+{
+public:
+    MoveList() : _size(0) { }
+
+    inline void add(int from, int to, int flags) { _moves[_size++] = BitMove(from, to, flags); }
+    inline void add(BitMove move) { _moves[_size++] = move; }
+
+    int size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    void clear() { _size = 0; }
+
+    BitMove& operator[](int index) { return _moves[index]; }
+    const BitMove& operator[](int index) const { return _moves[index]; }
+
+    BitMove* begin() { return _moves; }
+    BitMove* end() { return _moves + _size; }
+    const BitMove* begin() const { return _moves; }
+    const BitMove* end() const { return _moves + _size; }
+
+private:
+    BitMove _moves[MaxMoves];
+    int     _size;
+};
@@ -0,0 +1,197 @@
+#include "MovePicker.h"
+
+#include <utility>
+
+// History
+
+void HistoryTable::clear()
+{
+    for (auto& color : _scores)
+    {
+        for (auto& from : color)
+        {
+            for (int& score : from)
+            {
+                score = 0;
+            }
+        }
+    }
+}
+
+void HistoryTable::age()
+{
+    for (auto& color : _scores)
+    {
+        for (auto& from : color)
+        {
+            for (int& score : from)
+            {
+                score /= 2;
+            }
+        }
+    }
+}
+
+void HistoryTable::reward(int color, const BitMove& move, int depth)
+{
+    int& score = _scores[color][move.from()][move.to()];
+    score += depth * depth;
+
+    if (score > MaxScore)
+    {
+        age();
+    }
+}
+
+// Move picker
+
+MovePicker::MovePicker(const Position& position, MoveGenerator& generator, const BitMove& hashMove,
+                       const BitMove* killers, const HistoryTable& history)
+    : _position(position), _generator(generator), _history(history),
+      _hashMove(hashMove), _capturesOnly(false), _stage(StageHashMove), _index(0), _killerIndex(0)
+{
+    _killers[0] = killers ? killers[0] : BitMove();
+    _killers[1] = killers ? killers[1] : BitMove();
+
+    // A hash move that is not legal here (a key collision) is dropped
+    if (!_hashMove.isNull() && !_generator.isLegal(_hashMove))
+    {
+        _hashMove = BitMove();
+    }
+}
+
+MovePicker::MovePicker(const Position& position, MoveGenerator& generator, const HistoryTable& history)
+    : _position(position), _generator(generator), _history(history),
+      _hashMove(), _capturesOnly(true), _stage(StageGenerateCaptures), _index(0), _killerIndex(0)
+{
+    _killers[0] = _killers[1] = BitMove();
+}
+
+BitMove MovePicker::next()
+{
+    switch (_stage)
+    {
+        case StageHashMove:
+            _stage = StageGenerateCaptures;
+            if (!_hashMove.isNull())
+            {
+                return _hashMove;
+            }
+            [[fallthrough]];
+
+        case StageGenerateCaptures:
+            _generator.GenerateMoves(_moves, GenCaptures);
+            scoreCaptures();
+            _index = 0;
+            _stage = StageCaptures;
+            [[fallthrough]];
+
+        case StageCaptures:
+            while (_index < _moves.size())
+            {
+                BitMove move = pickBest();
+                if (move != _hashMove)
+                {
+                    return move;
+                }
+            }
+            if (_capturesOnly)
+            {
+                _stage = StageDone;
+                return BitMove();
+            }
+            _stage = StageKillers;
+            [[fallthrough]];
+
+        case StageKillers:
+            while (_killerIndex < 2)
+            {
+                BitMove killer = _killers[_killerIndex++];
+
+                if (!killer.isNull() && killer != _hashMove && !killer.isCapture() && !killer.isPromotion() &&
+                    (_killerIndex == 1 || killer != _killers[0]) && _generator.isLegal(killer))
+                {
+                    return killer;
+                }
+            }
+            _stage = StageGenerateQuiets;
+            [[fallthrough]];
+
+        case StageGenerateQuiets:
+            _moves.clear();
+            _generator.GenerateMoves(_moves, GenQuiets);
+            scoreQuiets();
+            _index = 0;
+            _stage = StageQuiets;
+            [[fallthrough]];
+
+        case StageQuiets:
+            while (_index < _moves.size())
+            {
+                BitMove move = pickBest();
+                if (!isSpecial(move))
+                {
+                    return move;
+                }
+            }
+            _stage = StageDone;
+            [[fallthrough]];
+
+        default:
+            return BitMove();
+    }
+}
+
+// Most valuable victim first, then least valuable attacker. Promotions
+// count the promoted piece as gained material.
+void MovePicker::scoreCaptures()
+{
+    for (int i = 0; i < _moves.size(); i++)
+    {
+        const BitMove& move = _moves[i];
+        int attacker = PieceType(_position.pieceBoardOn(move.from()));
+        int victim = (move.flags() == EnPassantCapture) ? Pawn
+                   : move.isCapture() ? PieceType(_position.pieceBoardOn(move.to())) : 0;
+
+        // The piece enum runs pawn..king, so it doubles as the LVA rank (king last)
+        int score = PieceValue[victim] * 8 - attacker;
+        if (move.isPromotion())
+        {
+            score += PieceValue[move.promotionPiece()] * 8;
+        }
+        _scores[i] = score;
+    }
+}
+
+void MovePicker::scoreQuiets()
+{
+    int us = _position.sideToMove;
+    for (int i = 0; i < _moves.size(); i++)
+    {
+        _scores[i] = _history.score(us, _moves[i]);
+    }
+}
+
+// Selection sort one step at a time: with cutoffs most of the list is
+// never looked at, so sorting all of it up front would be wasted work.
+BitMove MovePicker::pickBest()
+{
+    int best = _index;
+    for (int i = _index + 1; i < _moves.size(); i++)
+    {
+        if (_scores[i] > _scores[best])
+        {
+            best = i;
+        }
+    }
+
+    std::swap(_moves[_index], _moves[best]);
+    std::swap(_scores[_index], _scores[best]);
+    return _moves[_index++];
+}
+
+// Already handed out by the hash move or killer stage
+bool MovePicker::isSpecial(const BitMove& move) const
+{
+    return move == _hashMove || move == _killers[0] || move == _killers[1];
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Bitboard.h"
+#include "MoveGenerator.h"
+#include "MoveList.h"
+#include "Position.h"
+
+#include <cstdint>
+
+/*
+    Butterfly history: for each side and each from / to pair, how often a
+    quiet move caused a beta cutoff, weighted by depth. Quiet moves that
+    were good elsewhere in the tree are tried first.
+*/
+class HistoryTable
+{
+public:
+    HistoryTable() { clear(); }
+
+    void clear();
+    // Keep what was learned, but let the next search outweigh it
+    void age();
+
+    int score(int color, const BitMove& move) const { return _scores[color][move.from()][move.to()]; }
+    void reward(int color, const BitMove& move, int depth);
+
+private:
+    static constexpr int MaxScore = 1 << 20;
+
+    int _scores[2][64][64];
+};
+
+/*
+    Hands out the moves of a node one at a time, best guess first:
+
+    1. the hash move (from the transposition table)
+    2. captures and promotions, most valuable victim / least valuable attacker
+    3. the two killer moves of this ply
+    4. quiet moves, highest history score first
+
+    Each stage is generated only when the previous one is used up, so a
+    cutoff on the hash move never pays for move generation at all, and a
+    cutoff on a capture never generates the quiet moves. next() returns the
+    null move when there is nothing left.
+
+    The quiescence constructor skips straight to the capture stage and
+    stops after it.
+*/
+class MovePicker
+{
+public:
+    MovePicker(const Position& position, MoveGenerator& generator, const BitMove& hashMove,
+               const BitMove* killers, const HistoryTable& history);
+    MovePicker(const Position& position, MoveGenerator& generator, const HistoryTable& history);
+
+    BitMove next();
+
+private:
+    enum Stage
+    {
+        StageHashMove,
+        StageGenerateCaptures,
+        StageCaptures,
+        StageKillers,
+        StageGenerateQuiets,
+        StageQuiets,
+        StageDone
+    };
+
+    void scoreCaptures();
+    void scoreQuiets();
+    BitMove pickBest();
+    bool isSpecial(const BitMove& move) const;
+
+    const Position&     _position;
+    MoveGenerator&      _generator;
+    const HistoryTable& _history;
+
+    BitMove _hashMove;
+    BitMove _killers[2];
+
+    bool     _capturesOnly;
+    int      _stage;
+    int      _index;
+    int      _killerIndex;
+    MoveList _moves;
+    int      _scores[MaxMoves];
+};
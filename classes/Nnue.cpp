@@ -0,0 +1,329 @@
+#include "Nnue.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+// File layout, little endian: the magic, version and hidden size as uint32,
+// then int16 feature weights [NnueInputs][NnueHidden], feature biases
+// [NnueHidden], output weights [2 * NnueHidden] (side to move's half first)
+// and the output bias as int32.
+constexpr char     NetworkMagic[4] = { 'C', 'N', 'U', 'E' };
+constexpr uint32_t NetworkVersion = 1;
+
+struct alignas(64) Network
+{
+    int16_t featureWeights[NnueInputs][NnueHidden];
+    int16_t featureBias[NnueHidden];
+    int16_t outputWeights[2 * NnueHidden];
+    int32_t outputBias;
+};
+
+static Network TheNetwork;
+static bool Loaded = false;
+
+// Input index of a piece as seen by perspective: its own pieces come first
+// and black sees the board flipped, so both halves share the weights.
+static inline int FeatureIndex(int perspective, int board, int square)
+{
+    int relativeColor = PieceColor(board) ^ perspective;
+    int relativeSquare = perspective == White ? square : square ^ 56;
+    return (relativeColor * 6 + PieceType(board) - 1) * 64 + relativeSquare;
+}
+
+bool LoadNetwork(const std::string& path)
+{
+    Loaded = false;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0, hidden = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&hidden), sizeof(hidden));
+
+    if (!in || std::memcmp(magic, NetworkMagic, sizeof(magic)) != 0 || version != NetworkVersion || hidden != NnueHidden)
+    {
+        return false;
+    }
+
+    in.read(reinterpret_cast<char*>(TheNetwork.featureWeights), sizeof(TheNetwork.featureWeights));
+    in.read(reinterpret_cast<char*>(TheNetwork.featureBias), sizeof(TheNetwork.featureBias));
+    in.read(reinterpret_cast<char*>(TheNetwork.outputWeights), sizeof(TheNetwork.outputWeights));
+    in.read(reinterpret_cast<char*>(&TheNetwork.outputBias), sizeof(TheNetwork.outputBias));
+
+    for (int16_t& weight : TheNetwork.outputWeights)
+    {
+        weight = (int16_t)std::clamp<int>(weight, -NnueMaxOutputWeight, NnueMaxOutputWeight);
+    }
+
+    Loaded = (bool)in;
+    CHESS_TRACE_LOG(TraceEval, "nnue " << path << (Loaded ? " loaded, " : " truncated, ") << NnueKernelName() << " kernel");
+    return Loaded;
+}
+
+bool NetworkLoaded()
+{
+    return Loaded;
+}
+
+const char* NnueKernelName()
+{
+#if defined(CHESS_NNUE_AVX2)
+    return "avx2";
+#elif defined(CHESS_NNUE_SSE)
+    return "sse";
+#elif defined(CHESS_NNUE_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+// Kernels. Each one walks NnueHidden int16 lanes a register at a time; the
+// scalar versions double as the reference for the vector ones.
+
+#if defined(CHESS_NNUE_AVX2)
+
+constexpr int LanesPerRegister = 16;
+
+static inline void AddColumns(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+                              const int16_t* const* removed, int removedCount)
+{
+    for (int i = 0; i < NnueHidden; i += LanesPerRegister)
+    {
+        __m256i sum = _mm256_load_si256(reinterpret_cast<const __m256i*>(in + i));
+        for (int a = 0; a < addedCount; a++)
+        {
+            sum = _mm256_add_epi16(sum, _mm256_load_si256(reinterpret_cast<const __m256i*>(added[a] + i)));
+        }
+        for (int r = 0; r < removedCount; r++)
+        {
+            sum = _mm256_sub_epi16(sum, _mm256_load_si256(reinterpret_cast<const __m256i*>(removed[r] + i)));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out + i), sum);
+    }
+}
+
+static inline int32_t ClippedDot(const int16_t* values, const int16_t* weights)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ceiling = _mm256_set1_epi16(NnueQA);
+    __m256i sum = _mm256_setzero_si256();
+
+    for (int i = 0; i < NnueHidden; i += LanesPerRegister)
+    {
+        __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i));
+        v = _mm256_min_epi16(_mm256_max_epi16(v, zero), ceiling);
+        __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, w));
+    }
+
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+}
+
+#elif defined(CHESS_NNUE_SSE)
+
+constexpr int LanesPerRegister = 8;
+
+static inline void AddColumns(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+                              const int16_t* const* removed, int removedCount)
+{
+    for (int i = 0; i < NnueHidden; i += LanesPerRegister)
+    {
+        __m128i sum = _mm_load_si128(reinterpret_cast<const __m128i*>(in + i));
+        for (int a = 0; a < addedCount; a++)
+        {
+            sum = _mm_add_epi16(sum, _mm_load_si128(reinterpret_cast<const __m128i*>(added[a] + i)));
+        }
+        for (int r = 0; r < removedCount; r++)
+        {
+            sum = _mm_sub_epi16(sum, _mm_load_si128(reinterpret_cast<const __m128i*>(removed[r] + i)));
+        }
+        _mm_store_si128(reinterpret_cast<__m128i*>(out + i), sum);
+    }
+}
+
+static inline int32_t ClippedDot(const int16_t* values, const int16_t* weights)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ceiling = _mm_set1_epi16(NnueQA);
+    __m128i sum = _mm_setzero_si128();
+
+    for (int i = 0; i < NnueHidden; i += LanesPerRegister)
+    {
+        __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(values + i));
+        v = _mm_min_epi16(_mm_max_epi16(v, zero), ceiling);
+        __m128i w = _mm_load_si128(reinterpret_cast<const __m128i*>(weights + i));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(v, w));
+    }
+
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+
+#elif defined(CHESS_NNUE_NEON)
+
+constexpr int LanesPerRegister = 8;
+
+static inline void AddColumns(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+                              const int16_t* const* removed, int removedCount)
+{
+    for (int i = 0; i < NnueHidden; i += LanesPerRegister)
+    {
+        int16x8_t sum = vld1q_s16(in + i);
+        for (int a = 0; a < addedCount; a++)
+        {
+            sum = vaddq_s16(sum, vld1q_s16(added[a] + i));
+        }
+        for (int r = 0; r < removedCount; r++)
+        {
+            sum = vsubq_s16(sum, vld1q_s16(removed[r] + i));
+        }
+        vst1q_s16(out + i, sum);
+    }
+}
+
+static inline int32_t ClippedDot(const int16_t* values, const int16_t* weights)
+{
+    const int16x8_t zero = vdupq_n_s16(0);
+    const int16x8_t ceiling = vdupq_n_s16(NnueQA);
+    int32x4_t sum = vdupq_n_s32(0);
+
+    for (int i = 0; i < NnueHidden; i += LanesPerRegister)
+    {
+        int16x8_t v = vminq_s16(vmaxq_s16(vld1q_s16(values + i), zero), ceiling);
+        int16x8_t w = vld1q_s16(weights + i);
+        sum = vmlal_s16(sum, vget_low_s16(v), vget_low_s16(w));
+        sum = vmlal_s16(sum, vget_high_s16(v), vget_high_s16(w));
+    }
+
+    // vaddvq_s32 is AArch64 only; pairwise adds also work on 32-bit ARM
+    int32x2_t pair = vpadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+    pair = vpadd_s32(pair, pair);
+    return vget_lane_s32(pair, 0);
+}
+
+#else
+
+static inline void AddColumns(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+                              const int16_t* const* removed, int removedCount)
+{
+    for (int i = 0; i < NnueHidden; i++)
+    {
+        int16_t sum = in[i];
+        for (int a = 0; a < addedCount; a++)
+        {
+            sum += added[a][i];
+        }
+        for (int r = 0; r < removedCount; r++)
+        {
+            sum -= removed[r][i];
+        }
+        out[i] = sum;
+    }
+}
+
+static inline int32_t ClippedDot(const int16_t* values, const int16_t* weights)
+{
+    int32_t sum = 0;
+    for (int i = 0; i < NnueHidden; i++)
+    {
+        sum += std::clamp<int32_t>(values[i], 0, NnueQA) * weights[i];
+    }
+    return sum;
+}
+
+#endif
+
+void RefreshAccumulator(const Position& position, Accumulator& accumulator)
+{
+    for (int perspective = White; perspective <= Black; perspective++)
+    {
+        int16_t* values = accumulator.values[perspective];
+        std::memcpy(values, TheNetwork.featureBias, sizeof(TheNetwork.featureBias));
+
+        BitBoard occupied = position.occupancy();
+        occupied.forEachBit([&](int square) {
+            const int16_t* column = TheNetwork.featureWeights[FeatureIndex(perspective, position.pieceBoardOn(square), square)];
+            AddColumns(values, values, &column, 1, nullptr, 0);
+        });
+    }
+}
+
+FeatureDelta MoveFeatureDelta(const Position& position, const BitMove& move)
+{
+    FeatureDelta delta;
+    int us = position.sideToMove;
+    int from = move.from();
+    int to = move.to();
+    int moving = position.pieceBoardOn(from);
+
+    delta.remove(moving, from);
+    delta.add(move.isPromotion() ? PieceBoard(us, move.promotionPiece()) : moving, to);
+
+    if (move.flags() == EnPassantCapture)
+    {
+        delta.remove(PieceBoard(us ^ 1, Pawn), us == White ? to - 8 : to + 8);
+    }
+    else if (move.isCapture())
+    {
+        delta.remove(position.pieceBoardOn(to), to);
+    }
+    else if (move.isCastle())
+    {
+        int rookFrom, rookTo;
+        CastlingRookSquares(to, rookFrom, rookTo);
+        delta.remove(PieceBoard(us, Rook), rookFrom);
+        delta.add(PieceBoard(us, Rook), rookTo);
+    }
+
+    return delta;
+}
+
+void UpdateAccumulator(const Accumulator& input, Accumulator& output, const FeatureDelta& delta)
+{
+    for (int perspective = White; perspective <= Black; perspective++)
+    {
+        const int16_t* added[2];
+        const int16_t* removed[2];
+
+        for (int a = 0; a < delta.addedCount; a++)
+        {
+            added[a] = TheNetwork.featureWeights[FeatureIndex(perspective, delta.added[a][0], delta.added[a][1])];
+        }
+        for (int r = 0; r < delta.removedCount; r++)
+        {
+            removed[r] = TheNetwork.featureWeights[FeatureIndex(perspective, delta.removed[r][0], delta.removed[r][1])];
+        }
+
+        AddColumns(output.values[perspective], input.values[perspective], added, delta.addedCount, removed, delta.removedCount);
+    }
+}
+
+int EvaluateNnue(const Accumulator& accumulator, int sideToMove)
+{
+    int32_t sum = ClippedDot(accumulator.values[sideToMove], TheNetwork.outputWeights)
+                + ClippedDot(accumulator.values[sideToMove ^ 1], TheNetwork.outputWeights + NnueHidden);
+
+    // The bias is stored at the same NnueQA * NnueQB scale as the sum
+    int64_t score = ((int64_t)sum + TheNetwork.outputBias) * NnueScale / (NnueQA * NnueQB);
+    return (int)std::clamp<int64_t>(score, -30000, 30000);
+}
+
+int EvaluateNnue(const Position& position)
+{
+    Accumulator accumulator;
+    RefreshAccumulator(position, accumulator);
+    return EvaluateNnue(accumulator, position.sideToMove);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Bitboard.h"
+#include "Position.h"
+
+#include <cstdint>
+#include <string>
+
+#if defined(CHESS_NO_SIMD)
+#define CHESS_NNUE_SCALAR 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define CHESS_NNUE_AVX2 1
+#elif defined(__SSE4_1__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define CHESS_NNUE_SSE 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CHESS_NNUE_NEON 1
+#else
+#define CHESS_NNUE_SCALAR 1
+#endif
+
+/*
+    NNUE evaluation (an efficiently updatable neural network).
+
+    Inputs are the 768 (color, piece, square) features, seen from each
+    side: from black's point of view colors are swapped and the board is
+    mirrored, so one set of weights serves both perspectives. The first
+    layer maps them onto NnueHidden int16 neurons per perspective. Because
+    only a handful of features change per move, that layer's output (the
+    accumulator) is kept up to date by adding and subtracting weight
+    columns instead of being recomputed.
+
+    The output layer is a clipped ReLU of both accumulators, side to move
+    first, dotted with int16 weights into an int32 sum, then scaled to
+    centipawns. The dot product has AVX2, SSE and NEON kernels and a
+    scalar fallback (forced with CHESS_NO_SIMD).
+
+    Networks load from resources/ (see LoadNetwork for the file format).
+    Until one is loaded, NetworkLoaded() is false and callers keep using
+    the hand-written evaluation.
+*/
+
+constexpr int NnueInputs = 768;
+constexpr int NnueHidden = 256;
+
+// Quantization: accumulator activations are clipped to [0, NnueQA], output
+// weights are scaled by NnueQB, and NnueScale converts to centipawns
+constexpr int NnueQA = 255;
+constexpr int NnueQB = 64;
+constexpr int NnueScale = 400;
+
+// Output weights are clamped to +-NnueMaxOutputWeight on load, so the int32
+// dot product can't overflow: 2 * NnueHidden * NnueQA * 16384 < 2^31.
+constexpr int NnueMaxOutputWeight = 16384;
+static_assert(2LL * NnueHidden * NnueQA * NnueMaxOutputWeight <= INT32_MAX, "output dot product overflows int32");
+
+struct alignas(64) Accumulator
+{
+    int16_t values[2][NnueHidden];      // [perspective]
+};
+
+// Features a move removes and adds (a castling move touches four).
+struct FeatureDelta
+{
+    int removed[2][2];                  // { piece board, square }
+    int added[2][2];
+    int removedCount = 0;
+    int addedCount = 0;
+
+    void remove(int board, int square) { removed[removedCount][0] = board; removed[removedCount][1] = square; removedCount++; }
+    void add(int board, int square) { added[addedCount][0] = board; added[addedCount][1] = square; addedCount++; }
+};
+
+// Load a network, replacing the current one. Returns false (and leaves the
+// network unloaded) if the file is missing or does not match NnueHidden.
+bool LoadNetwork(const std::string& path);
+bool NetworkLoaded();
+
+// Name of the dot product kernel compiled in ("avx2", "sse", "neon", "scalar")
+const char* NnueKernelName();
+
+// Build an accumulator from scratch.
+void RefreshAccumulator(const Position& position, Accumulator& accumulator);
+
+// What the move about to be played on position changes.
+FeatureDelta MoveFeatureDelta(const Position& position, const BitMove& move);
+
+// output = input with delta applied (output may not alias input).
+void UpdateAccumulator(const Accumulator& input, Accumulator& output, const FeatureDelta& delta);
+
+// Centipawns from the side to move's point of view.
+int EvaluateNnue(const Accumulator& accumulator, int sideToMove);
+int EvaluateNnue(const Position& position);
@@ -0,0 +1,191 @@
+#include "ParallelSearch.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <map>
+#include <thread>
+
+ParallelSearch::ParallelSearch(TranspositionTable& table, int threads) : _table(table), _stop(false), _useNnue(false), _pruning(PruneAll)
+{
+    setThreads(threads);
+}
+
+int ParallelSearch::DefaultThreads()
+{
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+void ParallelSearch::setThreads(int threads)
+{
+    threads = std::max(1, threads);
+
+    _workers.clear();
+    for (int i = 0; i < threads; i++)
+    {
+        _workers.push_back(std::make_unique<Search>(_table));
+        _workers.back()->setStopFlag(&_stop);
+        _workers.back()->setUseNnue(_useNnue);
+        _workers.back()->setPruning(_pruning);
+        _workers.back()->setGameHistory(_gameKeys);
+    }
+    _workers[0]->setTimeManager(&_timer);
+    _workers[0]->setIterationCallback(_onIteration);
+}
+
+void ParallelSearch::setUseNnue(bool useNnue)
+{
+    _useNnue = useNnue;
+    for (auto& worker : _workers)
+    {
+        worker->setUseNnue(useNnue);
+    }
+}
+
+void ParallelSearch::setIterationCallback(IterationCallback callback)
+{
+    _onIteration = std::move(callback);
+    _workers[0]->setIterationCallback(_onIteration);
+}
+
+void ParallelSearch::setPruning(unsigned flags)
+{
+    _pruning = flags;
+    for (auto& worker : _workers)
+    {
+        worker->setPruning(flags);
+    }
+}
+
+void ParallelSearch::setGameHistory(const std::vector<uint64_t>& keys)
+{
+    _gameKeys = keys;
+    for (auto& worker : _workers)
+    {
+        worker->setGameHistory(keys);
+    }
+}
+
+SearchResult ParallelSearch::think(const Position& position, int maxDepth)
+{
+    SearchLimits limits;
+    limits.depth = maxDepth;
+    return think(position, limits);
+}
+
+SearchResult ParallelSearch::think(const Position& position, const SearchLimits& limits)
+{
+    _stop.store(false);
+    return run(position, limits);
+}
+
+std::future<SearchResult> ParallelSearch::thinkAsync(const Position& position, const SearchLimits& limits)
+{
+    _stop.store(false);
+    return std::async(std::launch::async, [this, position, limits]() { return run(position, limits); });
+}
+
+SearchResult ParallelSearch::run(const Position& position, const SearchLimits& limits)
+{
+    int maxDepth = limits.depth > 0 ? limits.depth : MaxPly - 1;
+
+    _timer.start(limits, position.sideToMove);
+    _table.newSearch();
+
+    // Helpers deepen without a limit of their own, staggered by one ply
+    // against each other, until the main thread is done
+    std::vector<std::future<SearchResult>> helpers;
+    for (size_t i = 1; i < _workers.size(); i++)
+    {
+        Search* helper = _workers[i].get();
+        int firstDepth = 1 + (int)(i & 1);
+
+        helpers.push_back(std::async(std::launch::async, [helper, position, firstDepth]() {
+            return helper->think(position, MaxPly - 1, firstDepth);
+        }));
+    }
+
+    std::vector<SearchResult> results;
+    results.push_back(_workers[0]->think(position, maxDepth));
+
+    _stop.store(true);
+    for (auto& helper : helpers)
+    {
+        results.push_back(helper.get());
+    }
+
+    uint64_t nodes = 0;
+    uint64_t pawnProbes = 0;
+    uint64_t pawnHits = 0;
+    PruningStats pruning{};
+    for (const SearchResult& result : results)
+    {
+        nodes += result.nodes;
+        pawnProbes += result.pawnProbes;
+        pawnHits += result.pawnHits;
+        pruning += result.pruning;
+    }
+
+    int chosen = 0;
+    Vote(results, chosen);
+
+    SearchResult best = results[chosen];
+    best.nodes = nodes;
+    best.pawnProbes = pawnProbes;
+    best.pawnHits = pawnHits;
+    best.pruning = pruning;
+
+    CHESS_TRACE_LOG(TraceSearch, "smp " << results.size() << " threads, thread " << chosen << " wins with "
+                                 << MoveToUCI(best.bestMove) << " depth " << best.depth << " nodes " << nodes
+                                 << " pawn hash hits " << (int)(best.pawnHitRate() * 100) << "%");
+    CHESS_TRACE_LOG(TraceSearch, "pruning " << PruningSummary(pruning));
+
+    return best;
+}
+
+// Weighted vote over every thread that finished at least one iteration.
+// chosen is the deepest thread (then best scoring) that picked the winner.
+BitMove ParallelSearch::Vote(const std::vector<SearchResult>& results, int& chosen)
+{
+    int minScore = posInfinity;
+    for (const SearchResult& result : results)
+    {
+        if (!result.bestMove.isNull())
+        {
+            minScore = std::min(minScore, result.score);
+        }
+    }
+
+    std::map<uint16_t, int64_t> votes;
+    for (const SearchResult& result : results)
+    {
+        if (!result.bestMove.isNull())
+        {
+            votes[result.bestMove.getData()] += (int64_t)(result.score - minScore + 14) * result.depth;
+        }
+    }
+
+    if (votes.empty())
+    {
+        chosen = 0;
+        return results[0].bestMove;
+    }
+
+    auto winner = std::max_element(votes.begin(), votes.end(),
+        [](const auto& a, const auto& b) { return a.second < b.second; });
+    BitMove move = BitMove::fromData(winner->first);
+
+    chosen = -1;
+    for (int i = 0; i < (int)results.size(); i++)
+    {
+        const SearchResult& result = results[i];
+        if (result.bestMove != move) { continue; }
+
+        if (chosen < 0 || result.depth > results[chosen].depth ||
+            (result.depth == results[chosen].depth && result.score > results[chosen].score))
+        {
+            chosen = i;
+        }
+    }
+
+    return move;
+}
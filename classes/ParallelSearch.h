@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Search.h"
+#include "TranspositionTable.h"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+/*
+    Lazy SMP: every thread runs its own iterative deepening search of the
+    same root, and the only thing they share is the transposition table.
+
+    Helper threads start one or two plies deeper than the main thread, so
+    at any moment different threads are filling different parts of the
+    table and each one's cutoffs speed up the others. The main thread owns
+    the depth limit: when it finishes, the helpers are stopped.
+
+    The move played is chosen by vote. Every thread votes for its best
+    move, weighted by how deep it got and by how much better its score is
+    than the worst thread's, so a deeper or more confident thread counts
+    for more but one lucky thread cannot overrule the rest.
+*/
+
+class ParallelSearch
+{
+public:
+    explicit ParallelSearch(TranspositionTable& table, int threads = DefaultThreads());
+
+    // One thread per hardware thread (at least one)
+    static int DefaultThreads();
+
+    void setThreads(int threads);
+    int threads() const { return (int)_workers.size(); }
+
+    // Passed on to every thread (see Search::setUseNnue)
+    void setUseNnue(bool useNnue);
+    void setPruning(unsigned flags);
+    // Keys of the game's earlier positions (see Search::setGameHistory)
+    void setGameHistory(const std::vector<uint64_t>& keys);
+
+    // Progress of the main thread (see Search::setIterationCallback)
+    void setIterationCallback(IterationCallback callback);
+
+    // Ask the current search to return early, from any thread. Once
+    // thinkAsync() has returned, a stop() is never lost, even if the search
+    // thread has not got going yet.
+    void stop() { _stop.store(true); }
+
+    // Start keeping time in a think() that began with limits.ponder
+    void ponderhit() { _timer.ponderhit(); }
+
+    // Search position to maxDepth on every thread. nodes, the pawn hash
+    // counts and the pruning stats are totals over all threads; the other
+    // fields come from the thread the vote picked.
+    SearchResult think(const Position& position, int maxDepth);
+
+    // The same under time control: the main thread runs the clock and the
+    // helpers stop when it does.
+    SearchResult think(const Position& position, const SearchLimits& limits);
+
+    // think() on a new thread. The stop flag is cleared before the thread is
+    // launched, so the caller can stop() and then simply wait on the future.
+    std::future<SearchResult> thinkAsync(const Position& position, const SearchLimits& limits);
+
+private:
+    // think() without clearing the stop flag first
+    SearchResult run(const Position& position, const SearchLimits& limits);
+
+    static BitMove Vote(const std::vector<SearchResult>& results, int& chosen);
+
+    TranspositionTable& _table;
+
+    std::vector<std::unique_ptr<Search>> _workers;
+    std::atomic<bool> _stop;
+    TimeManager _timer;
+    bool _useNnue;
+    unsigned _pruning;
+    std::vector<uint64_t> _gameKeys;
+    IterationCallback _onIteration;
+};
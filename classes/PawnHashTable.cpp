@@ -0,0 +1,38 @@
+#include "PawnHashTable.h"
+
+PawnHashTable::PawnHashTable(size_t entries) : _probes(0), _hits(0)
+{
+    // Round down to a power of two so the index is a mask
+    size_t size = 1;
+    while (size * 2 <= entries)
+    {
+        size *= 2;
+    }
+
+    _entries.resize(size);
+    _mask = size - 1;
+    clear();
+}
+
+void PawnHashTable::clear()
+{
+    for (PawnEntry& entry : _entries)
+    {
+        // ~0 marks an empty slot; a real pawn key matching it is vanishingly unlikely
+        entry = PawnEntry{ ~0ULL, { 0, 0 }, 0, 0 };
+    }
+    resetStats();
+}
+
+PawnEntry& PawnHashTable::probe(uint64_t key, bool& hit)
+{
+    PawnEntry& entry = _entries[key & _mask];
+
+    _probes++;
+    hit = entry.key == key;
+    if (hit)
+    {
+        _hits++;
+    }
+    return entry;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+    Cache of pawn structure evaluations, keyed by Position::pawnKey.
+
+    Pawns move rarely compared with the rest of the tree, so the same
+    structure is evaluated over and over. Each entry keeps the pawn score
+    and each side's passed pawns so other terms can use them without
+    recomputing. Each search thread owns its own table: entries are small
+    and cheap to rebuild, so there is nothing to gain from sharing.
+*/
+
+struct PawnEntry
+{
+    uint64_t key;
+    uint64_t passed[2];         // Passed pawns of each color
+    int16_t  middlegame;        // White minus black
+    int16_t  endgame;
+};
+
+class PawnHashTable
+{
+public:
+    static constexpr size_t DefaultEntries = 1 << 14;
+
+    explicit PawnHashTable(size_t entries = DefaultEntries);
+
+    // The slot for key. hit says whether it already holds key; on a miss
+    // the caller fills it in.
+    PawnEntry& probe(uint64_t key, bool& hit);
+
+    void clear();
+    void resetStats() { _probes = 0; _hits = 0; }
+
+    uint64_t probes() const { return _probes; }
+    uint64_t hits() const { return _hits; }
+
+private:
+    std::vector<PawnEntry> _entries;
+    uint64_t _mask;
+    uint64_t _probes;
+    uint64_t _hits;
+};
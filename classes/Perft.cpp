@@ -0,0 +1,41 @@
+#include "Perft.h"
+
+uint64_t Perft(Board& board, int depth, bool bulk)
+{
+    if (depth == 0) { return 1; }
+
+    MoveList moves;
+    MoveGenerator generator(board.position());
+    generator.GenerateAllMoves(moves);
+
+    if (bulk && depth == 1)
+    {
+        return moves.size();
+    }
+
+    uint64_t nodes = 0;
+    for (const BitMove& move : moves)
+    {
+        board.makeMove(move);
+        nodes += Perft(board, depth - 1, bulk);
+        board.unmakeMove();
+    }
+    return nodes;
+}
+
+std::vector<std::pair<BitMove, uint64_t>> Divide(Board& board, int depth, bool bulk)
+{
+    std::vector<std::pair<BitMove, uint64_t>> counts;
+
+    MoveList moves;
+    MoveGenerator generator(board.position());
+    generator.GenerateAllMoves(moves);
+
+    for (const BitMove& move : moves)
+    {
+        board.makeMove(move);
+        counts.emplace_back(move, Perft(board, depth - 1, bulk));
+        board.unmakeMove();
+    }
+    return counts;
+}
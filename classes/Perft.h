@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Board.h"
+#include "MoveGenerator.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/*
+    Perft walks the legal move tree to a fixed depth and counts the leaves.
+    The counts for well known positions are published, so any difference
+    points straight at a move generation or make/unmake bug.
+
+    With bulk counting the last ply is not played: the size of the legal
+    move list already is the number of leaves below that node.
+*/
+
+uint64_t Perft(Board& board, int depth, bool bulk = true);
+
+// Perft split by root move, for tracking down which subtree is wrong.
+std::vector<std::pair<BitMove, uint64_t>> Divide(Board& board, int depth, bool bulk = true);
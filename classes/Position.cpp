@@ -0,0 +1,215 @@
+#include "Position.h"
+#include "Fen.h"
+
+void Position::clear()
+{
+    for (int i = 0; i < e_numBitboards; i++)
+    {
+        bitboards[i] = 0ULL;
+    }
+    bitboards[EMPTY_SQUARES] = ~0ULL;
+
+    for (int square = 0; square < 64; square++)
+    {
+        mailbox[square] = NoPieceBoard;
+    }
+
+    sideToMove = White;
+    castlingRights = NoCastling;
+    enPassantSquare = NoSquare;
+    halfmoveClock = 0;
+    fullmoveNumber = 1;
+    zobristKey = 0;
+    pawnKey = 0;
+    material[White] = 0;
+    material[Black] = 0;
+    middlegame[White] = 0;
+    middlegame[Black] = 0;
+    endgame[White] = 0;
+    endgame[Black] = 0;
+    phase = 0;
+}
+
+bool Position::setFromFEN(std::string_view fen, std::string* error)
+{
+    return ParseFEN(fen, *this, error);
+}
+
+void Position::computeKeys()
+{
+    zobristKey = 0;
+    pawnKey = 0;
+
+    for (int square = 0; square < 64; square++)
+    {
+        int board = mailbox[square];
+        if (board == NoPieceBoard) { continue; }
+
+        zobristKey ^= Zobrist.pieces[board][square];
+        if (PieceType(board) == Pawn)
+        {
+            pawnKey ^= Zobrist.pieces[board][square];
+        }
+    }
+
+    zobristKey ^= Zobrist.castling[castlingRights];
+    if (enPassantSquare != NoSquare)
+    {
+        zobristKey ^= Zobrist.enPassant[enPassantSquare & 7];
+    }
+    if (sideToMove == Black)
+    {
+        zobristKey ^= Zobrist.side;
+    }
+}
+
+std::string SquareName(int square)
+{
+    std::string name;
+    name += (char)('a' + square % 8);
+    name += (char)('1' + square / 8);
+    return name;
+}
+
+std::string MoveToUCI(const BitMove& move)
+{
+    std::string text = SquareName(move.from()) + SquareName(move.to());
+    if (move.isPromotion())
+    {
+        text += "nbrq"[move.promotionPiece() - Knight];
+    }
+    return text;
+}
+
+// Castling rights that survive a move touching each square. Moving the king
+// or a rook (or capturing a rook on its home square) clears the matching bits.
+static const uint8_t CastlingMask[64] = {
+    (uint8_t)~WhiteQueenside, 15, 15, 15, (uint8_t)~(WhiteKingside | WhiteQueenside), 15, 15, (uint8_t)~WhiteKingside,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    (uint8_t)~BlackQueenside, 15, 15, 15, (uint8_t)~(BlackKingside | BlackQueenside), 15, 15, (uint8_t)~BlackKingside
+};
+
+void Position::makeMove(const BitMove& move, UndoInfo& undo)
+{
+    int us = sideToMove;
+    int from = move.from();
+    int to = move.to();
+    int moving = mailbox[from];
+
+    undo.castlingRights = castlingRights;
+    undo.enPassantSquare = enPassantSquare;
+    undo.halfmoveClock = halfmoveClock;
+    undo.zobristKey = zobristKey;
+    undo.pawnKey = pawnKey;
+
+    // Captures (en passant takes the pawn behind the target square)
+    int captureSquare = (move.flags() == EnPassantCapture) ? (us == White ? to - 8 : to + 8) : to;
+    undo.captured = mailbox[captureSquare];
+    removePiece(captureSquare);
+
+    // Move the piece, swapping it for the promoted piece if needed
+    removePiece(from);
+    addPiece(move.isPromotion() ? PieceBoard(us, move.promotionPiece()) : moving, to);
+
+    if (move.isCastle())
+    {
+        int rookFrom, rookTo;
+        CastlingRookSquares(to, rookFrom, rookTo);
+        removePiece(rookFrom);
+        addPiece(PieceBoard(us, Rook), rookTo);
+    }
+
+    // Game state, swapping the old castling / en passant keys for the new ones
+    if (enPassantSquare != NoSquare)
+    {
+        zobristKey ^= Zobrist.enPassant[enPassantSquare & 7];
+    }
+    enPassantSquare = (move.flags() == DoublePawnPush) ? (from + to) / 2 : NoSquare;
+    if (enPassantSquare != NoSquare)
+    {
+        zobristKey ^= Zobrist.enPassant[enPassantSquare & 7];
+    }
+
+    zobristKey ^= Zobrist.castling[castlingRights];
+    castlingRights &= CastlingMask[from] & CastlingMask[to];
+    zobristKey ^= Zobrist.castling[castlingRights];
+
+    bool resetsClock = PieceType(moving) == Pawn || undo.captured != NoPieceBoard;
+    halfmoveClock = resetsClock ? 0 : halfmoveClock + 1;
+
+    if (us == Black)
+    {
+        fullmoveNumber++;
+    }
+    sideToMove = us ^ 1;
+    zobristKey ^= Zobrist.side;
+}
+
+void Position::unmakeMove(const BitMove& move, const UndoInfo& undo)
+{
+    sideToMove ^= 1;
+    int us = sideToMove;
+    int from = move.from();
+    int to = move.to();
+
+    int moved = move.isPromotion() ? PieceBoard(us, Pawn) : mailbox[to];
+    removePiece(to);
+    addPiece(moved, from);
+
+    if (move.isCastle())
+    {
+        int rookFrom, rookTo;
+        CastlingRookSquares(to, rookFrom, rookTo);
+        removePiece(rookTo);
+        addPiece(PieceBoard(us, Rook), rookFrom);
+    }
+
+    if (undo.captured != NoPieceBoard)
+    {
+        int captureSquare = (move.flags() == EnPassantCapture) ? (us == White ? to - 8 : to + 8) : to;
+        addPiece(undo.captured, captureSquare);
+    }
+
+    if (us == Black)
+    {
+        fullmoveNumber--;
+    }
+    castlingRights = undo.castlingRights;
+    enPassantSquare = undo.enPassantSquare;
+    halfmoveClock = undo.halfmoveClock;
+    zobristKey = undo.zobristKey;
+    pawnKey = undo.pawnKey;
+}
+
+void Position::makeNullMove(UndoInfo& undo)
+{
+    undo.captured = NoPieceBoard;
+    undo.castlingRights = castlingRights;
+    undo.enPassantSquare = enPassantSquare;
+    undo.halfmoveClock = halfmoveClock;
+    undo.zobristKey = zobristKey;
+    undo.pawnKey = pawnKey;
+
+    if (enPassantSquare != NoSquare)
+    {
+        zobristKey ^= Zobrist.enPassant[enPassantSquare & 7];
+        enPassantSquare = NoSquare;
+    }
+
+    halfmoveClock++;
+    sideToMove ^= 1;
+    zobristKey ^= Zobrist.side;
+}
+
+void Position::unmakeNullMove(const UndoInfo& undo)
+{
+    sideToMove ^= 1;
+    enPassantSquare = undo.enPassantSquare;
+    halfmoveClock = undo.halfmoveClock;
+    zobristKey = undo.zobristKey;
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Bitboard.h"
+#include "Zobrist.h"
+#include "PieceSquareTables.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/*
+    A Position is the engine's copy of the board.
+
+    It keeps one bitboard per entry of the BitBoards enum, a 64-square
+    mailbox so "what is on this square" is a single load, and the game
+    state the GUI never tracked (side to move, castling, en passant,
+    clocks, hash key).
+
+    There are no pointers in here on purpose: a Position can be copied
+    with memcpy, handed to another thread, and searched without ever
+    touching the Grid, a ChessSquare or a Bit.
+*/
+
+enum CastlingRights : uint8_t
+{
+    NoCastling = 0,
+    WhiteKingside = 1,
+    WhiteQueenside = 2,
+    BlackKingside = 4,
+    BlackQueenside = 8,
+    AllCastling = 15
+};
+
+constexpr int NoSquare = -1;
+
+// Mailbox value for a square with nothing on it.
+constexpr uint8_t NoPieceBoard = EMPTY_SQUARES;
+
+// Material value of each ChessPiece, in centipawns.
+constexpr int PieceValue[7] = { 0, 100, 320, 330, 500, 900, 0 };
+
+// Everything makeMove() destroys and unmakeMove() needs back.
+struct UndoInfo
+{
+    uint8_t  captured;          // BitBoards index of the captured piece, or NoPieceBoard
+    uint8_t  castlingRights;
+    int8_t   enPassantSquare;
+    uint8_t  halfmoveClock;
+    uint64_t zobristKey;
+    uint64_t pawnKey;
+};
+
+struct Position
+{
+    BitBoard bitboards[e_numBitboards];
+    uint8_t  mailbox[64];
+
+    uint8_t  sideToMove;
+    uint8_t  castlingRights;
+    int8_t   enPassantSquare;
+    uint8_t  halfmoveClock;
+    uint16_t fullmoveNumber;
+
+    uint64_t zobristKey;        // Zobrist hash of the whole position
+    uint64_t pawnKey;           // Zobrist hash of the pawns alone
+
+    int16_t  material[2];       // Running material total per color
+    int16_t  middlegame[2];     // Running material + piece-square totals per color
+    int16_t  endgame[2];
+    uint8_t  phase;             // Sum of PhaseWeight over the board (can exceed MaxPhase)
+
+    // Empty board, white to move, no rights.
+    void clear();
+
+    // Load a FEN string (see Fen.h). False, with the position cleared, if
+    // it is malformed or illegal.
+    bool setFromFEN(std::string_view fen, std::string* error = nullptr);
+
+    // Apply / take back a move. Everything is updated incrementally, the
+    // caller just has to hand the same UndoInfo back to unmakeMove().
+    void makeMove(const BitMove& move, UndoInfo& undo);
+    void unmakeMove(const BitMove& move, const UndoInfo& undo);
+
+    // Pass the turn (for null move pruning): no piece moves, the en passant
+    // square goes away. Never legal in check.
+    void makeNullMove(UndoInfo& undo);
+    void unmakeNullMove(const UndoInfo& undo);
+
+    // Recompute zobristKey and pawnKey from scratch. Only needed after
+    // editing the state fields directly; make / unmake keep them current.
+    void computeKeys();
+
+    // Place / lift a single piece, keeping the colour and occupancy boards in step.
+    inline void addPiece(int board, int square)
+    {
+        uint64_t bit = 1ULL << square;
+        int allBoard = PieceColor(board) == White ? WHITE_ALL : BLACK_ALL;
+
+        bitboards[board] |= bit;
+        bitboards[allBoard] |= bit;
+        bitboards[OCCUPANCY] |= bit;
+        bitboards[EMPTY_SQUARES].setData(bitboards[EMPTY_SQUARES].getData() & ~bit);
+        mailbox[square] = (uint8_t)board;
+        material[PieceColor(board)] += PieceValue[PieceType(board)];
+        middlegame[PieceColor(board)] += PieceSquare.middlegame[board][square];
+        endgame[PieceColor(board)] += PieceSquare.endgame[board][square];
+        phase += PhaseWeight[PieceType(board)];
+
+        zobristKey ^= Zobrist.pieces[board][square];
+        if (PieceType(board) == Pawn)
+        {
+            pawnKey ^= Zobrist.pieces[board][square];
+        }
+    }
+
+    inline void removePiece(int square)
+    {
+        int board = mailbox[square];
+        if (board == NoPieceBoard) { return; }
+
+        uint64_t bit = 1ULL << square;
+        int allBoard = PieceColor(board) == White ? WHITE_ALL : BLACK_ALL;
+
+        bitboards[board].setData(bitboards[board].getData() & ~bit);
+        bitboards[allBoard].setData(bitboards[allBoard].getData() & ~bit);
+        bitboards[OCCUPANCY].setData(bitboards[OCCUPANCY].getData() & ~bit);
+        bitboards[EMPTY_SQUARES] |= bit;
+        mailbox[square] = NoPieceBoard;
+        material[PieceColor(board)] -= PieceValue[PieceType(board)];
+        middlegame[PieceColor(board)] -= PieceSquare.middlegame[board][square];
+        endgame[PieceColor(board)] -= PieceSquare.endgame[board][square];
+        phase -= PhaseWeight[PieceType(board)];
+
+        zobristKey ^= Zobrist.pieces[board][square];
+        if (PieceType(board) == Pawn)
+        {
+            pawnKey ^= Zobrist.pieces[board][square];
+        }
+    }
+
+    // Getters
+
+    int pieceBoardOn(int square) const { return mailbox[square]; }
+    bool isEmpty(int square) const { return mailbox[square] == NoPieceBoard; }
+
+    uint64_t pieces(int board) const { return bitboards[board].getData(); }
+    uint64_t pieces(int color, int piece) const { return bitboards[PieceBoard(color, piece)].getData(); }
+    uint64_t colorPieces(int color) const { return bitboards[color == White ? WHITE_ALL : BLACK_ALL].getData(); }
+    uint64_t occupancy() const { return bitboards[OCCUPANCY].getData(); }
+
+    // Anything but pawns and the king (null move is unsafe without it: zugzwang)
+    bool hasNonPawnMaterial(int color) const { return colorPieces(color) & ~(pieces(color, Pawn) | pieces(color, King)); }
+
+    uint64_t key() const { return zobristKey; }
+};
+
+constexpr const char* StartingFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Rook squares for a castling king landing on "to".
+inline void CastlingRookSquares(int to, int& rookFrom, int& rookTo)
+{
+    bool kingside = (to & 7) == 6;
+    rookFrom = kingside ? to + 1 : to - 2;
+    rookTo = kingside ? to - 1 : to + 1;
+}
+
+// Coordinate notation helpers ("e4", "e7e8q")
+std::string SquareName(int square);
+std::string MoveToUCI(const BitMove& move);
+
+static_assert(std::is_trivially_copyable_v<Position>, "Position must stay memcpy-able");
@@ -0,0 +1,623 @@
+#include "Search.h"
+#include "Evaluate.h"
+#include "MoveGenerator.h"
+#include "MovePicker.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+// Mate scores are stored relative to the node, not the root, so the same
+// mate found through a different move order still reads correctly.
+static int ScoreToTable(int score, int ply)
+{
+    if (score >= MateBound) { return score + ply; }
+    if (score <= -MateBound) { return score - ply; }
+    return score;
+}
+
+static int ScoreFromTable(int score, int ply)
+{
+    if (score >= MateBound) { return score - ply; }
+    if (score <= -MateBound) { return score + ply; }
+    return score;
+}
+
+// Nodes between polls of the stop flag
+constexpr uint64_t StopCheckInterval = 1024;
+
+// Positional slack allowed for by delta pruning in quiescence
+constexpr int DeltaMargin = 200;
+
+// Null move: reduce by this much, plus a ply per 4 of depth and per 200
+// centipawns (up to 3) that the static evaluation is above beta
+constexpr int NullMoveBaseReduction = 3;
+constexpr int NullMoveMinDepth = 3;
+
+// Reverse futility: a node this shallow whose evaluation beats beta by the
+// margin per ply is assumed to fail high
+constexpr int ReverseFutilityDepth = 6;
+constexpr int ReverseFutilityMargin = 80;
+
+// Futility: at this depth or less, quiet moves are skipped when even the
+// static evaluation plus a margin per ply can't reach alpha
+constexpr int FutilityDepth = 3;
+constexpr int FutilityMargin = 100;
+
+// Late move pruning: quiet moves after the first 3 + depth^2 are skipped
+constexpr int LateMovePruningDepth = 3;
+
+// Aspiration windows: the first is the last score +/- AspirationWindow from
+// AspirationMinDepth on, doubling on each failure until past the maximum
+constexpr int AspirationWindow = 25;
+constexpr int AspirationMinDepth = 5;
+constexpr int AspirationMaxWindow = 1000;
+
+// Late move reductions start at this depth and move number
+constexpr int ReductionMinDepth = 3;
+constexpr int ReductionMinMove = 3;
+
+// Reduction by depth and move number: log(depth) * log(moves), so it grows
+// slowly along both
+static const auto ReductionTable = [] {
+    std::array<std::array<int8_t, 64>, MaxPly> table{};
+    for (int depth = 1; depth < MaxPly; depth++)
+    {
+        for (int move = 1; move < 64; move++)
+        {
+            table[depth][move] = (int8_t)(0.75 + std::log(depth) * std::log(move) / 2.25);
+        }
+    }
+    return table;
+}();
+
+PruningStats& PruningStats::operator+=(const PruningStats& other)
+{
+    nullMoveTries += other.nullMoveTries;
+    nullMoveCutoffs += other.nullMoveCutoffs;
+    reductions += other.reductions;
+    reSearches += other.reSearches;
+    reverseFutility += other.reverseFutility;
+    futility += other.futility;
+    lateMoves += other.lateMoves;
+    pvsReSearches += other.pvsReSearches;
+    aspirationFails += other.aspirationFails;
+    return *this;
+}
+
+std::string PruningSummary(const PruningStats& stats)
+{
+    return "null " + std::to_string(stats.nullMoveCutoffs) + "/" + std::to_string(stats.nullMoveTries) +
+           " lmr " + std::to_string(stats.reSearches) + "/" + std::to_string(stats.reductions) +
+           " rfp " + std::to_string(stats.reverseFutility) + " futility " + std::to_string(stats.futility) +
+           " lmp " + std::to_string(stats.lateMoves) + " pvs " + std::to_string(stats.pvsReSearches) +
+           " aspiration " + std::to_string(stats.aspirationFails);
+}
+
+Search::Search(TranspositionTable& table) : _table(table), _stop(nullptr), _timer(nullptr), _aborted(false), _nodes(0), _rootBest(), _pruning(PruneAll), _stats{}, _useNnue(false), _nnueActive(false), _pvLength{}
+{
+}
+
+SearchResult Search::think(const Position& position, int maxDepth, int firstDepth)
+{
+    SearchResult result{};
+    result.score = negInfinity;
+
+    _board.setPosition(position);
+    _sinceNull[0] = MaxPly + (int)_gameKeys.size();
+    _nodes = 0;
+    _rootBest = BitMove();
+    _aborted = false;
+
+    for (auto& killers : _killers)
+    {
+        killers[0] = killers[1] = BitMove();
+    }
+    _history.age();
+    _pawnTable.resetStats();
+    _stats = PruningStats{};
+
+    _nnueActive = _useNnue && NetworkLoaded();
+    if (_nnueActive)
+    {
+        RefreshAccumulator(position, _accumulators[0]);
+    }
+
+    maxDepth = std::clamp(maxDepth, 1, MaxPly - 1);
+    firstDepth = std::clamp(firstDepth, 1, maxDepth);
+
+    int score = 0;
+    for (int depth = firstDepth; depth <= maxDepth; depth++)
+    {
+        // Aspiration: expect about the last iteration's score, widening the
+        // window on whichever side the result falls outside it
+        int window = AspirationWindow;
+        int alpha = negInfinity;
+        int beta = posInfinity;
+
+        if (depth >= AspirationMinDepth && std::abs(score) < MateBound)
+        {
+            alpha = score - window;
+            beta = score + window;
+        }
+
+        while (true)
+        {
+            score = negamax(depth, 0, alpha, beta);
+
+            if (_aborted || (score > alpha && score < beta))
+            {
+                break;
+            }
+
+            _stats.aspirationFails++;
+            window *= 2;
+
+            if (score <= alpha)
+            {
+                beta = (alpha + beta) / 2;
+                alpha = window > AspirationMaxWindow ? negInfinity : std::max(score - window, negInfinity);
+            }
+            else
+            {
+                beta = window > AspirationMaxWindow ? posInfinity : std::min(score + window, posInfinity);
+            }
+        }
+
+        // A stopped iteration is incomplete: keep the previous one
+        if (_aborted)
+        {
+            break;
+        }
+
+        // No legal moves at the root: nothing to play
+        if (_pvLength[0] == 0)
+        {
+            result.score = score;
+            break;
+        }
+
+        _rootBest = _pv[0][0];
+
+        result.bestMove = _pv[0][0];
+        result.score = score;
+        result.depth = depth;
+        result.pvLength = _pvLength[0];
+        std::copy(_pv[0], _pv[0] + _pvLength[0], result.pv);
+
+        CHESS_TRACE_LOG(TraceSearch, "depth " << depth << " score " << score << " nodes " << _nodes
+                                     << " best " << MoveToUCI(result.bestMove));
+
+        if (_onIteration)
+        {
+            result.nodes = _nodes;
+            result.pawnProbes = _pawnTable.probes();
+            result.pawnHits = _pawnTable.hits();
+            result.pruning = _stats;
+            _onIteration(result);
+        }
+
+        // A forced mate will not get any shorter by searching deeper
+        if (std::abs(score) >= MateBound)
+        {
+            break;
+        }
+
+        if (_timer && _timer->stopAfterIteration(depth, result.bestMove, score))
+        {
+            break;
+        }
+    }
+
+    result.nodes = _nodes;
+    result.pawnProbes = _pawnTable.probes();
+    result.pawnHits = _pawnTable.hits();
+    result.pruning = _stats;
+    return result;
+}
+
+int Search::negamax(int depth, int ply, int alpha, int beta, bool allowNull)
+{
+    if (depth <= 0)
+    {
+        return quiescence(ply, alpha, beta);
+    }
+
+    _pvLength[ply] = 0;
+    _nodes++;
+
+    if (checkStop())
+    {
+        return 0;
+    }
+
+    const Position& position = _board.position();
+
+    // Fifty move rule, and a position seen before in the game or this line
+    if (ply > 0 && (position.halfmoveClock >= 100 || isRepetition(ply)))
+    {
+        return 0;
+    }
+
+    if (ply >= MaxPly - 1)
+    {
+        return evaluate(ply);
+    }
+
+    // A deep enough stored result with a usable bound answers this node
+    // outright. Never at the root, which has to produce a move and a PV.
+    TTData entry;
+    bool hit = _table.probe(position.zobristKey, entry);
+    BitMove hashMove = hit ? entry.move : BitMove();
+
+    if (hit && ply > 0 && entry.depth >= depth)
+    {
+        int score = ScoreFromTable(entry.score, ply);
+
+        if (entry.bound == BoundExact ||
+            (entry.bound == BoundLower && score >= beta) ||
+            (entry.bound == BoundUpper && score <= alpha))
+        {
+            return score;
+        }
+    }
+
+    MoveGenerator generator(position);
+    bool inCheck = generator.inCheck();
+    bool pvNode = beta - alpha > 1;
+    int staticEval = inCheck ? negInfinity : evaluate(ply);
+
+    // Selectivity only off the principal variation, out of check, and with
+    // beta a normal score (mate bounds must be proven, not guessed)
+    bool prunable = !pvNode && !inCheck && std::abs(beta) < MateBound;
+
+    // Reverse futility: far enough above beta that no reply will bring it back
+    if (prunable && (_pruning & PruneReverseFutility) && depth <= ReverseFutilityDepth &&
+        staticEval - ReverseFutilityMargin * depth >= beta)
+    {
+        _stats.reverseFutility++;
+        return staticEval;
+    }
+
+    // Null move: if passing still fails high, a real move would too. Not
+    // twice in a row, and not with only pawns left (zugzwang).
+    if (prunable && (_pruning & PruneNullMove) && allowNull && depth >= NullMoveMinDepth &&
+        staticEval >= beta && position.hasNonPawnMaterial(position.sideToMove))
+    {
+        int reduction = NullMoveBaseReduction + depth / 4 + std::min((staticEval - beta) / 200, 3);
+
+        _stats.nullMoveTries++;
+        makeNullMove(ply);
+        int score = -negamax(depth - 1 - reduction, ply + 1, -beta, -beta + 1, false);
+        _board.unmakeNullMove();
+
+        if (_aborted)
+        {
+            return 0;
+        }
+
+        if (score >= beta)
+        {
+            _stats.nullMoveCutoffs++;
+            return score >= MateBound ? beta : score;
+        }
+    }
+
+    // Search the previous iteration's best move (or the stored move) first
+    if (ply == 0 && !_rootBest.isNull())
+    {
+        hashMove = _rootBest;
+    }
+
+    MovePicker picker(position, generator, hashMove, _killers[ply], _history);
+
+    int originalAlpha = alpha;
+    int bestScore = negInfinity;
+    BitMove bestMove = BitMove();
+    int moveCount = 0;
+
+    for (BitMove move = picker.next(); !move.isNull(); move = picker.next())
+    {
+        moveCount++;
+
+        bool quiet = !move.isCapture() && !move.isPromotion();
+
+        bool givesCheck = quiet && MoveGenerator::GivesCheck(position, move);
+
+        // Shallow quiet moves that can't matter, once one move has a real score.
+        // Decided before the move is made, so a pruned move costs no make / unmake
+        if (prunable && quiet && !givesCheck && moveCount > 1 && bestScore > -MateBound)
+        {
+            if ((_pruning & PruneLateMoves) && depth <= LateMovePruningDepth && moveCount > 3 + depth * depth)
+            {
+                _stats.lateMoves++;
+                continue;
+            }
+
+            if ((_pruning & PruneFutility) && depth <= FutilityDepth && staticEval + FutilityMargin * depth <= alpha)
+            {
+                _stats.futility++;
+                continue;
+            }
+        }
+
+        makeMove(move, ply);
+
+        // Late quiet moves first get a shallower search; only one that beats
+        // alpha there is searched again at full depth
+        int reduction = 0;
+        if ((_pruning & PruneLateMoveReductions) && depth >= ReductionMinDepth && moveCount >= ReductionMinMove &&
+            quiet && !inCheck && !givesCheck)
+        {
+            reduction = ReductionTable[depth][std::min(moveCount, 63)] - (pvNode ? 1 : 0);
+            reduction = std::clamp(reduction, 0, depth - 2);
+        }
+
+        // Principal variation search: the first move gets the full window,
+        // the rest only have to be shown no better than it with a null window
+        int score;
+        if (moveCount == 1)
+        {
+            score = -negamax(depth - 1, ply + 1, -beta, -alpha);
+        }
+        else
+        {
+            if (reduction > 0)
+            {
+                _stats.reductions++;
+                score = -negamax(depth - 1 - reduction, ply + 1, -alpha - 1, -alpha);
+
+                if (score > alpha)
+                {
+                    _stats.reSearches++;
+                    score = -negamax(depth - 1, ply + 1, -alpha - 1, -alpha);
+                }
+            }
+            else
+            {
+                score = -negamax(depth - 1, ply + 1, -alpha - 1, -alpha);
+            }
+
+            // Better than the PV move after all: find out by how much
+            if (score > alpha && score < beta)
+            {
+                _stats.pvsReSearches++;
+                score = -negamax(depth - 1, ply + 1, -beta, -alpha);
+            }
+        }
+        _board.unmakeMove();
+
+        if (_aborted)
+        {
+            return 0;
+        }
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestMove = move;
+
+            if (score > alpha)
+            {
+                alpha = score;
+                updatePV(ply, move);
+
+                if (alpha >= beta)
+                {
+                    // Quiet moves that refute a line are worth trying early elsewhere
+                    if (!move.isCapture() && !move.isPromotion())
+                    {
+                        storeKiller(ply, move);
+                        _history.reward(position.sideToMove, move, depth);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // Checkmate or stalemate
+    if (moveCount == 0)
+    {
+        return generator.inCheck() ? -MateScore + ply : 0;
+    }
+
+    BoundType bound = bestScore >= beta ? BoundLower : (bestScore > originalAlpha ? BoundExact : BoundUpper);
+    _table.store(position.zobristKey, bound == BoundUpper ? BitMove() : bestMove, ScoreToTable(bestScore, ply), depth, bound);
+
+    return bestScore;
+}
+
+// Captures (and, in check, every evasion) until the position is quiet.
+int Search::quiescence(int ply, int alpha, int beta)
+{
+    _pvLength[ply] = 0;
+    _nodes++;
+
+    if (checkStop())
+    {
+        return 0;
+    }
+
+    const Position& position = _board.position();
+    int standPat = evaluate(ply);
+
+    if (ply >= MaxPly - 1)
+    {
+        return standPat;
+    }
+
+    MoveGenerator generator(position);
+    bool inCheck = generator.inCheck();
+    int bestScore = negInfinity;
+
+    // Stand pat: the side to move can usually do at least as well as the
+    // static score by not capturing. Not an option when in check.
+    if (!inCheck)
+    {
+        if (standPat >= beta)
+        {
+            return standPat;
+        }
+        alpha = std::max(alpha, standPat);
+        bestScore = standPat;
+    }
+
+    MovePicker picker = inCheck ? MovePicker(position, generator, BitMove(), _killers[ply], _history)
+                                : MovePicker(position, generator, _history);
+    int moveCount = 0;
+
+    for (BitMove move = picker.next(); !move.isNull(); move = picker.next())
+    {
+        moveCount++;
+
+        if (!inCheck)
+        {
+            // Delta pruning: even winning the victim for free can't lift alpha
+            if (!move.isPromotion())
+            {
+                int victim = (move.flags() == EnPassantCapture) ? Pawn : PieceType(position.pieceBoardOn(move.to()));
+                if (standPat + PieceValue[victim] + DeltaMargin <= alpha)
+                {
+                    continue;
+                }
+            }
+
+            // Captures that lose material in the exchange
+            if (MoveGenerator::StaticExchange(position, move) < 0)
+            {
+                continue;
+            }
+        }
+
+        makeMove(move, ply);
+        int score = -quiescence(ply + 1, -beta, -alpha);
+        _board.unmakeMove();
+
+        if (_aborted)
+        {
+            return 0;
+        }
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+
+            if (score > alpha)
+            {
+                alpha = score;
+                updatePV(ply, move);
+
+                if (alpha >= beta)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    // Checkmated
+    if (inCheck && moveCount == 0)
+    {
+        return -MateScore + ply;
+    }
+
+    return bestScore;
+}
+
+// Static evaluation of the current node, from the side to move's view.
+int Search::evaluate(int ply)
+{
+    const Position& position = _board.position();
+    return _nnueActive ? EvaluateNnue(_accumulators[ply], position.sideToMove) : Evaluate(position, _pawnTable);
+}
+
+// Play move, bringing the next ply's accumulator up to date first (it needs
+// the position before the move to know what was captured or castled).
+void Search::makeMove(const BitMove& move, int ply)
+{
+    if (_nnueActive)
+    {
+        UpdateAccumulator(_accumulators[ply], _accumulators[ply + 1], MoveFeatureDelta(_board.position(), move));
+    }
+    _keyStack[ply] = _board.position().zobristKey;
+    _sinceNull[ply + 1] = _sinceNull[ply] + 1;
+    _board.makeMove(move);
+}
+
+// Pass the turn; the pieces, and so the accumulator, stay as they are.
+void Search::makeNullMove(int ply)
+{
+    if (_nnueActive)
+    {
+        std::memcpy(&_accumulators[ply + 1], &_accumulators[ply], sizeof(Accumulator));
+    }
+    _keyStack[ply] = _board.position().zobristKey;
+    _sinceNull[ply + 1] = 0;
+    _board.makeNullMove();
+}
+
+// Has the position at ply been seen before, in this line or the game before
+// the root? Only positions since the last capture or pawn move (and the last
+// null move) can recur, with the same side to move every second ply.
+bool Search::isRepetition(int ply) const
+{
+    const Position& position = _board.position();
+    int reach = std::min((int)position.halfmoveClock, _sinceNull[ply]);
+
+    for (int back = 2; back <= reach; back += 2)
+    {
+        int earlier = ply - back;
+        if (earlier < 0 && (int)_gameKeys.size() + earlier < 0)
+        {
+            break;
+        }
+
+        uint64_t key = earlier >= 0 ? _keyStack[earlier] : _gameKeys[_gameKeys.size() + earlier];
+        if (key == position.zobristKey)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Poll the shared stop flag and the clock every StopCheckInterval nodes.
+// Neither can end the search before the first iteration has found a move,
+// so there is always a move to play.
+bool Search::checkStop()
+{
+    if ((_nodes % StopCheckInterval) != 0 || _rootBest.isNull())
+    {
+        return _aborted;
+    }
+
+    if (_stop && _stop->load(std::memory_order_relaxed))
+    {
+        _aborted = true;
+    }
+    else if (_timer && (_timer->hardExpired() || _timer->nodesExpired(_nodes)))
+    {
+        _aborted = true;
+    }
+    return _aborted;
+}
+
+void Search::storeKiller(int ply, const BitMove& move)
+{
+    if (_killers[ply][0] != move)
+    {
+        _killers[ply][1] = _killers[ply][0];
+        _killers[ply][0] = move;
+    }
+}
+
+// The line below ply is move followed by the line below ply + 1.
+void Search::updatePV(int ply, const BitMove& move)
+{
+    _pv[ply][0] = move;
+    std::copy(_pv[ply + 1], _pv[ply + 1] + _pvLength[ply + 1], _pv[ply] + 1);
+    _pvLength[ply] = _pvLength[ply + 1] + 1;
+}
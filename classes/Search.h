@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Board.h"
+#include "MoveList.h"
+#include "MovePicker.h"
+#include "Nnue.h"
+#include "PawnHashTable.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+    Iterative deepening negamax with alpha-beta pruning.
+
+    Each iteration searches the root one ply deeper than the last, starting
+    with the best move of the previous iteration. The principal variation
+    is collected in a triangular table as the search unwinds, so the line
+    of the deepest finished iteration is always available. From depth 5
+    each iteration starts with a narrow (aspiration) window around the
+    previous score, widening it only if the result falls outside.
+
+    Only the first move of a node is searched with the full window (the
+    principal variation search); the others just have to be shown no
+    better, with a null window, and are searched again if they are.
+
+    Away from the principal variation the tree is cut down selectively:
+    null move pruning and reverse futility skip nodes that are already
+    far above beta, futility and late move pruning skip quiet moves that
+    can't matter near the leaves, and late quiet moves are searched
+    shallower (late move reductions) unless they turn out to beat alpha.
+
+    Scores are from the point of view of the side to move. A mate found
+    n plies from the root scores MateScore - n, so shorter mates win.
+*/
+
+constexpr int negInfinity = -1000000;
+constexpr int posInfinity = +1000000;
+
+// Mate scores must fit the 16-bit score of a transposition table entry
+constexpr int MateScore = 32000;
+constexpr int MaxPly = 64;
+
+// Scores beyond this are mates, not material
+constexpr int MateBound = MateScore - MaxPly;
+
+// Selective search techniques, switchable one by one (see Search::setPruning)
+enum PruningFlags : unsigned
+{
+    PruneNone = 0,
+    PruneNullMove = 1,
+    PruneLateMoveReductions = 2,
+    PruneReverseFutility = 4,
+    PruneFutility = 8,
+    PruneLateMoves = 16,
+    PruneAll = 31
+};
+
+// How often each technique fired, to measure what it does to the tree
+struct PruningStats
+{
+    uint64_t nullMoveTries;
+    uint64_t nullMoveCutoffs;
+    uint64_t reductions;        // Late moves searched at reduced depth
+    uint64_t reSearches;        // ... that then beat alpha and were searched again
+    uint64_t reverseFutility;   // Nodes cut on their static evaluation
+    uint64_t futility;          // Quiet moves skipped as hopeless
+    uint64_t lateMoves;         // Quiet moves skipped for coming too late
+
+    uint64_t pvsReSearches;     // Null window searches that beat alpha and needed the full window
+    uint64_t aspirationFails;   // Root searches that fell outside their window
+
+    PruningStats& operator+=(const PruningStats& other);
+};
+
+// One line of counters, e.g. "null 812/1530 lmr 96/4410 rfp 2210 ..."
+std::string PruningSummary(const PruningStats& stats);
+
+struct SearchResult
+{
+    BitMove  bestMove;
+    int      score;
+    int      depth;             // Deepest fully searched iteration
+    uint64_t nodes;
+
+    uint64_t pawnProbes;        // Pawn hash table lookups during the search
+    uint64_t pawnHits;
+
+    double pawnHitRate() const { return pawnProbes ? (double)pawnHits / pawnProbes : 0.0; }
+
+    PruningStats pruning;
+
+    BitMove  pv[MaxPly];
+    int      pvLength;
+};
+
+// Called with the result so far after every finished iteration
+using IterationCallback = std::function<void(const SearchResult&)>;
+
+class Search
+{
+public:
+    explicit Search(TranspositionTable& table);
+
+    // Search position, deepening from firstDepth to maxDepth plies, and
+    // return the deepest finished iteration. bestMove is the null move only
+    // when the side to move has no legal move (or was stopped at depth 1).
+    // The caller starts a new table age (TranspositionTable::newSearch()).
+    SearchResult think(const Position& position, int maxDepth, int firstDepth = 1);
+
+    // Once *stop turns true the search unwinds and think() returns the last
+    // finished iteration. nullptr means never stop early.
+    void setStopFlag(const std::atomic<bool>* stop) { _stop = stop; }
+
+    // Stop on this clock's deadlines as well (started by the caller). The
+    // first iteration always finishes, so there is always a move to play.
+    void setTimeManager(TimeManager* timer) { _timer = timer; }
+
+    // Runs on the searching thread, so it must be quick and thread safe.
+    void setIterationCallback(IterationCallback callback) { _onIteration = std::move(callback); }
+
+    // Evaluate with the loaded NNUE instead of the hand-written evaluation.
+    // Ignored while no network is loaded.
+    void setUseNnue(bool useNnue) { _useNnue = useNnue; }
+
+    // Which PruningFlags to use (all of them by default).
+    void setPruning(unsigned flags) { _pruning = flags; }
+
+    // Zobrist keys of the positions played before the root, oldest first,
+    // so a return to one of them is scored as a draw. Only while not thinking.
+    void setGameHistory(const std::vector<uint64_t>& keys) { _gameKeys = keys; }
+
+private:
+    int  negamax(int depth, int ply, int alpha, int beta, bool allowNull = true);
+    int  quiescence(int ply, int alpha, int beta);
+    bool checkStop();
+    int  evaluate(int ply);
+    void makeMove(const BitMove& move, int ply);
+    void makeNullMove(int ply);
+    void updatePV(int ply, const BitMove& move);
+    void storeKiller(int ply, const BitMove& move);
+    bool isRepetition(int ply) const;
+
+    TranspositionTable& _table;
+    const std::atomic<bool>* _stop;
+    TimeManager* _timer;
+    IterationCallback _onIteration;
+    bool     _aborted;
+
+    Board    _board;
+    uint64_t _nodes;
+
+    BitMove  _rootBest;         // Tried first at the root of the next iteration
+    BitMove  _killers[MaxPly][2];
+    HistoryTable _history;
+    PawnHashTable _pawnTable;
+
+    unsigned _pruning;
+    PruningStats _stats;
+
+    bool     _useNnue;
+    bool     _nnueActive;       // _useNnue and a network loaded, fixed for one think()
+    Accumulator _accumulators[MaxPly + 1];  // [ply], so unmaking a move costs nothing
+
+    std::vector<uint64_t> _gameKeys;
+    uint64_t _keyStack[MaxPly + 1];     // [ply], key of the position a move was made from
+    int      _sinceNull[MaxPly + 1];    // [ply], plies since the last null move (repetitions don't cross one)
+
+    BitMove  _pv[MaxPly][MaxPly];
+    int      _pvLength[MaxPly];
+};
@@ -1,7 +1,9 @@
 #pragma once
 #include "Entity.h"
+#include "TextureCache.h"
 #include "../imgui/imgui.h"
 #include <cstdint>
+#include <string>
 
 class Sprite : public Entity
 {
@@ -17,11 +19,17 @@ public:
         _scale(1),
         _color(1, 1, 1, 1),
         _localZOrder(0),
+        _texture(0),
+        _uv0(0, 0),
+        _uv1(1, 1),
         _highlighted(false)
         { 
             _entityType = EntitySprite;
         };
-    ~Sprite() { if (_retainCount > 0) release(); }
+    ~Sprite() { releaseTexture(); if (_retainCount > 0) release(); }
+    // sprites share textures through the TextureCache, so they can't be copied
+    Sprite(const Sprite &) = delete;
+    Sprite &operator=(const Sprite &) = delete;
     
     // set the texture to use for this sprite
     void setPosition(float x, float y)
@@ -67,7 +75,7 @@ public:
         {
             ImGui::SetCursorPos(_location);
             ImVec4 highlight = _highlighted ? ImVec4(1, 1, 0, 1) : ImVec4(0, 0, 0, 0);
-            ImGui::Image((void*)(intptr_t)_texture, _size, ImVec2(0, 0), ImVec2(1, 1), _color, highlight);
+            ImGui::Image((void*)(intptr_t)_texture, _size, _uv0, _uv1, _color, highlight);
         }
     }
 	// is the mouse over this position?
@@ -101,10 +109,13 @@ protected:
     ImVec4  _color;
     // the local Z order
     int _localZOrder;
-    // the texture we're going to draw
+    // the texture we're going to draw, the part of it that is ours, and the cache key
     ImTextureID _texture;
+    ImVec2      _uv0;
+    ImVec2      _uv1;
+    std::string _textureName;
     // currently highlighted
    	bool	_highlighted;
-    // private platform specific texture loading
-    ImTextureID _loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height);
+    // hand our texture reference back to the cache
+    void releaseTexture();
 };
@@ -0,0 +1,248 @@
+#include "TextureCache.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+std::unordered_map<std::string, TextureCache::Texture> TextureCache::_textures;
+std::unordered_map<std::string, TextureCache::Entry>   TextureCache::_entries;
+
+// transparent pixels between atlas cells so linear filtering never picks up a neighbour
+constexpr int AtlasPadding = 2;
+
+static ImTextureID CreateTexture(const unsigned char *image_data, int image_width, int image_height);
+static void DestroyTexture(ImTextureID texture);
+
+static unsigned char *LoadImage(const std::string &filename, int &width, int &height)
+{
+    std::string path = (std::filesystem::path("resources") / filename).string();
+    unsigned char *image_data = stbi_load(path.c_str(), &width, &height, NULL, 4);
+    if (image_data == NULL) {
+        std::cout << "Failed to load texture: " << path << std::endl;
+    }
+    return image_data;
+}
+
+bool TextureCache::acquire(const std::string &filename, TextureRegion &region)
+{
+    auto entry = _entries.find(filename);
+    if (entry != _entries.end()) {
+        _textures[entry->second.texture].references++;
+        region = entry->second.region;
+        return true;
+    }
+
+    int width = 0;
+    int height = 0;
+    unsigned char *image_data = LoadImage(filename, width, height);
+    if (image_data == NULL) {
+        return false;
+    }
+    ImTextureID id = CreateTexture(image_data, width, height);
+    stbi_image_free(image_data);
+    if (id == 0) {
+        return false;
+    }
+
+    _textures[filename] = Texture{ id, 1 };
+    region = TextureRegion{ id, ImVec2(0, 0), ImVec2(1, 1), ImVec2((float)width, (float)height) };
+    _entries[filename] = Entry{ filename, region };
+    return true;
+}
+
+void TextureCache::release(const std::string &filename)
+{
+    auto entry = _entries.find(filename);
+    if (entry != _entries.end()) {
+        releaseTexture(entry->second.texture);
+    }
+}
+
+bool TextureCache::buildAtlas(const std::string &atlasName, const std::vector<std::string> &filenames)
+{
+    auto existing = _textures.find(atlasName);
+    if (existing != _textures.end()) {
+        existing->second.references++;
+        return true;
+    }
+
+    struct Image { std::string filename; unsigned char *data; int width; int height; };
+    std::vector<Image> images;
+    int cellWidth = 0;
+    int cellHeight = 0;
+
+    for (const std::string &filename : filenames) {
+        // a file already loaded on its own keeps its texture
+        if (_entries.count(filename)) {
+            continue;
+        }
+        Image image{ filename, nullptr, 0, 0 };
+        image.data = LoadImage(filename, image.width, image.height);
+        if (image.data) {
+            cellWidth = std::max(cellWidth, image.width + AtlasPadding);
+            cellHeight = std::max(cellHeight, image.height + AtlasPadding);
+            images.push_back(image);
+        }
+    }
+    if (images.empty()) {
+        return false;
+    }
+
+    // square-ish grid of equal cells; piece images are all the same size
+    int columns = (int)std::ceil(std::sqrt((double)images.size()));
+    int rows = ((int)images.size() + columns - 1) / columns;
+    int atlasWidth = columns * cellWidth;
+    int atlasHeight = rows * cellHeight;
+    std::vector<unsigned char> pixels((size_t)atlasWidth * atlasHeight * 4, 0);
+
+    for (size_t i = 0; i < images.size(); i++) {
+        int x = (int)(i % columns) * cellWidth;
+        int y = (int)(i / columns) * cellHeight;
+        for (int row = 0; row < images[i].height; row++) {
+            std::memcpy(&pixels[((size_t)(y + row) * atlasWidth + x) * 4],
+                        images[i].data + (size_t)row * images[i].width * 4,
+                        (size_t)images[i].width * 4);
+        }
+    }
+
+    ImTextureID id = CreateTexture(pixels.data(), atlasWidth, atlasHeight);
+    if (id != 0) {
+        _textures[atlasName] = Texture{ id, 1 };
+    }
+
+    for (size_t i = 0; i < images.size(); i++) {
+        if (id != 0) {
+            float x = (float)((int)(i % columns) * cellWidth);
+            float y = (float)((int)(i / columns) * cellHeight);
+            TextureRegion region;
+            region.texture = id;
+            region.uv0 = ImVec2(x / atlasWidth, y / atlasHeight);
+            region.uv1 = ImVec2((x + images[i].width) / atlasWidth, (y + images[i].height) / atlasHeight);
+            region.size = ImVec2((float)images[i].width, (float)images[i].height);
+            _entries[images[i].filename] = Entry{ atlasName, region };
+        }
+        stbi_image_free(images[i].data);
+    }
+
+    return id != 0;
+}
+
+void TextureCache::releaseAtlas(const std::string &atlasName)
+{
+    if (_textures.count(atlasName)) {
+        releaseTexture(atlasName);
+    }
+}
+
+void TextureCache::releaseTexture(const std::string &name)
+{
+    auto texture = _textures.find(name);
+    if (texture == _textures.end() || --texture->second.references > 0) {
+        return;
+    }
+
+    DestroyTexture(texture->second.id);
+    _textures.erase(texture);
+
+    for (auto entry = _entries.begin(); entry != _entries.end();) {
+        if (entry->second.texture == name) {
+            entry = _entries.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+}
+
+#if !defined(_WIN32)
+#include "../imgui/imgui_impl_opengl3_loader.h"
+
+static ImTextureID CreateTexture(const unsigned char *image_data, int image_width, int image_height)
+{
+    // Create a OpenGL texture identifier
+    GLuint image_texture;
+    glGenTextures(1, &image_texture);
+    glBindTexture(GL_TEXTURE_2D, image_texture);
+
+    // Setup filtering parameters for display
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Upload pixels into texture
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_width, image_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image_data);
+
+    return static_cast<ImTextureID>(image_texture);
+}
+
+static void DestroyTexture(ImTextureID texture)
+{
+    GLuint image_texture = (GLuint)(intptr_t)texture;
+    glDeleteTextures(1, &image_texture);
+}
+
+#endif
+#ifdef _WIN32
+
+// DirectX
+#include <stdio.h>
+#include <d3d11.h>
+#include <d3dcompiler.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "d3dcompiler") // Automatically link with d3dcompiler.lib as we are using D3DCompile() below.
+#endif
+
+static ImTextureID CreateTexture(const unsigned char *image_data, int image_width, int image_height)
+{
+    // Create texture
+    D3D11_TEXTURE2D_DESC desc;
+    ZeroMemory(&desc, sizeof(desc));
+    desc.Width = image_width;
+    desc.Height = image_height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.CPUAccessFlags = 0;
+
+    ID3D11Texture2D *pTexture = NULL;
+    D3D11_SUBRESOURCE_DATA subResource;
+    subResource.pSysMem = image_data;
+    subResource.SysMemPitch = desc.Width * 4;
+    subResource.SysMemSlicePitch = 0;
+
+    // You need to have a valid ID3D11Device* available as g_pd3dDevice
+    extern ID3D11Device* g_pd3dDevice; // Add this line if g_pd3dDevice is defined elsewhere
+
+    HRESULT hr = g_pd3dDevice->CreateTexture2D(&desc, &subResource, &pTexture);
+    if (FAILED(hr) || !pTexture) {
+        return 0;
+    }
+
+    // Create texture view
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+    ZeroMemory(&srvDesc, sizeof(srvDesc));
+    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = desc.MipLevels;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+
+    ID3D11ShaderResourceView* shaderResourceView = nullptr;
+    hr = g_pd3dDevice->CreateShaderResourceView(pTexture, &srvDesc, &shaderResourceView);
+    pTexture->Release();
+
+    if (FAILED(hr) || !shaderResourceView) {
+
+        return 0;
+    }
+    return reinterpret_cast<ImTextureID>(shaderResourceView);
+}
+
+static void DestroyTexture(ImTextureID texture)
+{
+    reinterpret_cast<ID3D11ShaderResourceView*>(texture)->Release();
+}
+#endif
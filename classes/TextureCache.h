@@ -0,0 +1,58 @@
+#pragma once
+#include "../imgui/imgui.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//
+// process-wide cache of GPU textures, keyed by the file name under resources/
+//
+// every sprite showing the same image shares one texture: the first acquire()
+// decodes the png and uploads it, later ones just bump a reference count, and
+// the texture is destroyed when the last reference is released.
+//
+// buildAtlas() packs a set of images into a single texture up front. files in
+// an atlas are then handed out as regions of it, so a board full of pieces is
+// drawn from one texture (imgui merges the draws into a single command).
+// the atlas holds its own reference until releaseAtlas(), so pieces can be
+// deleted and recreated on a reset without decoding anything again.
+//
+
+struct TextureRegion
+{
+    ImTextureID texture = 0;
+    ImVec2      uv0 = ImVec2(0, 0);
+    ImVec2      uv1 = ImVec2(1, 1);
+    ImVec2      size = ImVec2(0, 0);     // pixels of the original image
+};
+
+class TextureCache
+{
+public:
+    // region for filename, loading it if needed; false if it can't be loaded
+    static bool acquire(const std::string &filename, TextureRegion &region);
+    // drop a reference taken by acquire()
+    static void release(const std::string &filename);
+
+    // pack filenames into one texture named atlasName; false if none loaded
+    static bool buildAtlas(const std::string &atlasName, const std::vector<std::string> &filenames);
+    static void releaseAtlas(const std::string &atlasName);
+
+private:
+    struct Texture
+    {
+        ImTextureID id = 0;
+        int         references = 0;
+    };
+
+    struct Entry
+    {
+        std::string    texture;     // key into _textures: the file, or the atlas holding it
+        TextureRegion  region;
+    };
+
+    static void releaseTexture(const std::string &name);
+
+    static std::unordered_map<std::string, Texture> _textures;
+    static std::unordered_map<std::string, Entry>   _entries;
+};
@@ -0,0 +1,100 @@
+#include "TimeManager.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <iterator>
+
+// Milliseconds lost per move to I/O and the GUI, kept in reserve
+constexpr int64_t MoveOverhead = 30;
+
+// Moves the remaining time is spread over when the control doesn't say
+constexpr int DefaultMovesToGo = 30;
+
+// The hard limit may stretch a soft limit this far, but never past this
+// share of the clock
+constexpr int64_t MaxStretch = 4;
+constexpr double  MaxClockShare = 0.75;
+
+// Soft limit scale by how many iterations in a row kept the best move
+constexpr double StabilityScale[] = { 1.6, 1.3, 1.1, 0.95, 0.85, 0.75 };
+
+// A score drop of this many centipawns (or more) doubles the soft limit
+constexpr int DropForDouble = 100;
+
+TimeManager::TimeManager() : _start(0), _pondering(false), _active(false), _soft(0), _hard(0), _nodeLimit(0), _previousBest(), _previousScore(0), _stability(0)
+{
+}
+
+void TimeManager::start(const SearchLimits& limits, int sideToMove)
+{
+    _start.store(Now());
+    _pondering.store(limits.ponder);
+    _nodeLimit = limits.nodes;
+    _previousBest = BitMove();
+    _previousScore = 0;
+    _stability = 0;
+    _active = true;
+
+    if (limits.moveTime >= 0)
+    {
+        _soft = _hard = std::max<int64_t>(1, limits.moveTime - MoveOverhead);
+    }
+    else if (limits.time[sideToMove] >= 0)
+    {
+        int64_t left = std::max<int64_t>(1, limits.time[sideToMove] - MoveOverhead);
+        int movesToGo = limits.movesToGo > 0 ? std::min(limits.movesToGo, 50) : DefaultMovesToGo;
+
+        _soft = left / movesToGo + limits.increment[sideToMove] * 3 / 4;
+        _hard = std::min<int64_t>(_soft * MaxStretch, (int64_t)(left * MaxClockShare));
+        _hard = std::max<int64_t>(1, _hard);
+        _soft = std::clamp<int64_t>(_soft, 1, _hard);
+    }
+    else
+    {
+        _active = false;
+        _soft = _hard = 0;
+    }
+
+    CHESS_TRACE_LOG(TraceSearch, "time soft " << _soft << "ms hard " << _hard << "ms" << (_active ? "" : " (untimed)"));
+}
+
+int64_t TimeManager::Now()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t TimeManager::elapsed() const
+{
+    return Now() - _start.load(std::memory_order_relaxed);
+}
+
+void TimeManager::ponderhit()
+{
+    _start.store(Now(), std::memory_order_relaxed);
+    _pondering.store(false, std::memory_order_release);
+}
+
+bool TimeManager::stopAfterIteration(int depth, const BitMove& bestMove, int score)
+{
+    bool first = _previousBest.isNull();
+
+    _stability = (!first && bestMove == _previousBest) ? _stability + 1 : 0;
+    int drop = first ? 0 : std::clamp(_previousScore - score, 0, DropForDouble);
+
+    _previousBest = bestMove;
+    _previousScore = score;
+
+    if (!_active || _pondering.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    constexpr int LastStability = (int)std::size(StabilityScale) - 1;
+    double scale = StabilityScale[std::min(_stability, LastStability)] * (1.0 + (double)drop / DropForDouble);
+    int64_t limit = std::min<int64_t>((int64_t)(_soft * scale), _hard);
+
+    CHESS_TRACE_LOG(TraceSearch, "time depth " << depth << " elapsed " << elapsed() << "ms limit " << limit
+                                 << "ms stability " << _stability << " drop " << drop);
+
+    return elapsed() >= limit;
+}
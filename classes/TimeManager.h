@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Bitboard.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/*
+    Clock handling for a timed search.
+
+    start() turns the limits into two deadlines. The soft one is what a
+    move should normally take; it is checked between iterations, scaled by
+    how the search is going: a best move that keeps surviving deeper
+    iterations shrinks it, a score that just dropped stretches it. The hard
+    one is never passed; the search polls it every thousand or so nodes and
+    unwinds as soon as it expires.
+
+    With neither a clock nor a move time the manager is inactive and the
+    search runs to its depth (or node) limit. A ponder search holds the
+    deadlines off until ponderhit(), which restarts the clock.
+*/
+
+struct SearchLimits
+{
+    int     depth = 0;              // 0 = no depth limit
+    int64_t time[2] = { -1, -1 };   // Milliseconds left per color (wtime / btime), -1 = none
+    int64_t increment[2] = { 0, 0 };
+    int     movesToGo = 0;          // Moves to the next time control, 0 = rest of the game
+    int64_t moveTime = -1;          // Exact milliseconds for this move, -1 = none
+    uint64_t nodes = 0;             // Main thread node budget, 0 = none
+    bool    ponder = false;         // Wait for ponderhit() before keeping time
+};
+
+class TimeManager
+{
+public:
+    TimeManager();
+
+    // Start the clock for a search by sideToMove.
+    void start(const SearchLimits& limits, int sideToMove);
+
+    bool active() const { return _active; }
+    int64_t elapsed() const;
+    int64_t softLimit() const { return _soft; }
+    int64_t hardLimit() const { return _hard; }
+
+    // Cheap enough to call from the node loop.
+    bool hardExpired() const { return _active && !_pondering.load(std::memory_order_acquire) && elapsed() >= _hard; }
+    bool nodesExpired(uint64_t nodes) const { return _nodeLimit && nodes >= _nodeLimit; }
+
+    // The ponder move was played: start keeping time, from now. Safe to
+    // call from another thread while the search runs.
+    void ponderhit();
+
+    // Called after each finished iteration: whether to stop deepening.
+    bool stopAfterIteration(int depth, const BitMove& bestMove, int score);
+
+private:
+    static int64_t Now();
+
+    std::atomic<int64_t> _start;    // Now() when the clock started
+    std::atomic<bool> _pondering;
+
+    bool    _active;
+    int64_t _soft;
+    int64_t _hard;
+    uint64_t _nodeLimit;
+
+    BitMove _previousBest;
+    int     _previousScore;
+    int     _stability;             // Iterations in a row with the same best move
+};
@@ -0,0 +1,111 @@
+#include "Trace.h"
+
+#ifdef CHESS_TRACE
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+// Write the buffer out once it holds this many bytes
+constexpr size_t TraceFlushThreshold = 64 * 1024;
+
+static uint32_t CategoriesFromEnvironment()
+{
+    const char* value = std::getenv("CHESS_TRACE");
+    if (value == nullptr) { return TraceNone; }
+
+    std::string names = value;
+    uint32_t categories = TraceNone;
+
+    if (names.find("all") != std::string::npos)     { categories |= TraceAll; }
+    if (names.find("movegen") != std::string::npos) { categories |= TraceMoveGen; }
+    if (names.find("search") != std::string::npos)  { categories |= TraceSearch; }
+    if (names.find("eval") != std::string::npos)    { categories |= TraceEval; }
+
+    return categories;
+}
+
+// Atomic because TraceEnable() may run while search threads are tracing.
+// Relaxed is enough: it guards no other data, a thread only has to see the
+// new set eventually.
+static std::atomic<uint32_t>& EnabledCategories()
+{
+    static std::atomic<uint32_t> categories(CategoriesFromEnvironment());
+    return categories;
+}
+
+// Lines are built in a per-thread stream and appended to the shared buffer
+// whole, so search threads never interleave inside a line.
+struct TraceBuffer
+{
+    std::mutex  mutex;
+    std::string text;
+
+    // Flush whatever is left when the program exits
+    ~TraceBuffer() { write(); }
+
+    void write()
+    {
+        if (text.empty()) { return; }
+        std::fwrite(text.data(), 1, text.size(), stderr);
+        text.clear();
+    }
+};
+
+static TraceBuffer& Buffer()
+{
+    static TraceBuffer buffer;
+    return buffer;
+}
+
+static std::ostringstream& LineStream()
+{
+    thread_local std::ostringstream line;
+    return line;
+}
+
+void TraceEnable(uint32_t categories)
+{
+    EnabledCategories().store(categories, std::memory_order_relaxed);
+}
+
+bool TraceEnabled(uint32_t category)
+{
+    return (EnabledCategories().load(std::memory_order_relaxed) & category) != 0;
+}
+
+std::ostream& TraceStream()
+{
+    return LineStream();
+}
+
+void TraceEndLine()
+{
+    std::ostringstream& line = LineStream();
+    line << '\n';
+
+    TraceBuffer& buffer = Buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    buffer.text += line.str();
+    line.str(std::string());
+
+    if (buffer.text.size() >= TraceFlushThreshold)
+    {
+        buffer.write();
+    }
+}
+
+void TraceFlush()
+{
+    TraceBuffer& buffer = Buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    buffer.write();
+    std::fflush(stderr);
+}
+
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Bitboard.h"
+
+#include <cstdint>
+#include <ostream>
+
+/*
+    Debug tracing for the engine.
+
+    Trace calls are written with the CHESS_TRACE_* macros. Unless the build
+    defines CHESS_TRACE (CMake does for Debug builds) the macros expand to
+    nothing, so the hot paths carry no I/O, no branches and no formatting.
+
+    In a trace build each line belongs to a category, and only the enabled
+    categories are written. The initial set comes from the CHESS_TRACE
+    environment variable ("movegen,search,eval" or "all"), and can be
+    changed with TraceEnable(). Lines collect in a memory buffer that is
+    written to stderr in large blocks, never flushed per line.
+*/
+
+enum TraceCategory : uint32_t
+{
+    TraceNone    = 0,
+    TraceMoveGen = 1 << 0,
+    TraceSearch  = 1 << 1,
+    TraceEval    = 1 << 2,
+    TraceAll     = TraceMoveGen | TraceSearch | TraceEval
+};
+
+#ifdef CHESS_TRACE
+
+void TraceEnable(uint32_t categories);
+bool TraceEnabled(uint32_t category);
+
+// The buffered sink. TraceEndLine() finishes a line and writes the buffer
+// out once it is large enough; TraceFlush() writes whatever is left.
+std::ostream& TraceStream();
+void TraceEndLine();
+void TraceFlush();
+
+#define CHESS_TRACE_LOG(category, message)                      \
+    do {                                                        \
+        if (TraceEnabled(category)) {                           \
+            TraceStream() << message;                           \
+            TraceEndLine();                                     \
+        }                                                       \
+    } while (0)
+
+#define CHESS_TRACE_BITBOARD(category, message, board)          \
+    do {                                                        \
+        if (TraceEnabled(category)) {                           \
+            TraceStream() << message;                           \
+            BitBoard(board).printBitBoard(TraceStream());       \
+            TraceEndLine();                                     \
+        }                                                       \
+    } while (0)
+
+#else
+
+inline void TraceEnable(uint32_t) { }
+inline bool TraceEnabled(uint32_t) { return false; }
+inline void TraceFlush() { }
+
+#define CHESS_TRACE_LOG(category, message) do { } while (0)
+#define CHESS_TRACE_BITBOARD(category, message, board) do { } while (0)
+
+#endif
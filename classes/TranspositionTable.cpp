@@ -0,0 +1,134 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable(size_t megabytes) : _mask(0), _megabytes(0), _age(0)
+{
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes)
+{
+    if (megabytes == 0) { megabytes = 1; }
+
+    // Round down to a power of two so the bucket index is a mask
+    size_t buckets = 1;
+    while (buckets * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024)
+    {
+        buckets *= 2;
+    }
+
+    _buckets.reset(new Bucket[buckets]);
+    _mask = buckets - 1;
+    _megabytes = megabytes;
+    clear();
+}
+
+void TranspositionTable::clear()
+{
+    for (uint64_t i = 0; i <= _mask; i++)
+    {
+        for (Entry& entry : _buckets[i].entries)
+        {
+            entry.keyXorData.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    _age = 0;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTData& result) const
+{
+    const Bucket& bucket = _buckets[key & _mask];
+
+    for (const Entry& entry : bucket.entries)
+    {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.keyXorData.load(std::memory_order_relaxed);
+
+        if ((check ^ data) == key && BoundOf(data) != BoundNone)
+        {
+            result.move = MoveOf(data);
+            result.score = (int16_t)ScoreOf(data);
+            result.depth = (int8_t)DepthOf(data);
+            result.bound = (uint8_t)BoundOf(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, BitMove move, int score, int depth, BoundType bound)
+{
+    Bucket& bucket = _buckets[key & _mask];
+    Entry* target = nullptr;
+
+    // Same position already stored. A much shallower, non-exact result from
+    // this search (a qsearch store from another thread, say) must not wipe
+    // out a deep entry: then only the move and age are refreshed.
+    for (Entry& entry : bucket.entries)
+    {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.keyXorData.load(std::memory_order_relaxed) ^ data) == key)
+        {
+            if (move.isNull())
+            {
+                move = MoveOf(data);
+            }
+
+            if (bound != BoundExact && BoundOf(data) != BoundNone && AgeOf(data) == _age &&
+                depth < DepthOf(data) - SameKeyDepthMargin)
+            {
+                uint64_t refreshed = Pack(move, ScoreOf(data), DepthOf(data), (BoundType)BoundOf(data), _age);
+                entry.data.store(refreshed, std::memory_order_relaxed);
+                entry.keyXorData.store(key ^ refreshed, std::memory_order_relaxed);
+                return;
+            }
+
+            target = &entry;
+            break;
+        }
+    }
+
+    // Otherwise the shallowest depth-preferred slot this search may replace,
+    // falling back to the always-replace slot
+    if (target == nullptr)
+    {
+        target = &bucket.entries[EntriesPerBucket - 1];
+        int shallowest = depth + 1;
+
+        for (int i = 0; i < EntriesPerBucket - 1; i++)
+        {
+            Entry& entry = bucket.entries[i];
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            int storedDepth = (BoundOf(data) == BoundNone || AgeOf(data) != _age) ? -1 : DepthOf(data);
+
+            if (storedDepth < shallowest)
+            {
+                shallowest = storedDepth;
+                target = &entry;
+            }
+        }
+    }
+
+    uint64_t data = Pack(move, score, depth, bound, _age);
+    target->data.store(data, std::memory_order_relaxed);
+    target->keyXorData.store(key ^ data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const
+{
+    int used = 0;
+    uint64_t sample = _mask + 1 < 250 ? _mask + 1 : 250;
+
+    for (uint64_t i = 0; i < sample; i++)
+    {
+        for (const Entry& entry : _buckets[i].entries)
+        {
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if (BoundOf(data) != BoundNone && AgeOf(data) == _age)
+            {
+                used++;
+            }
+        }
+    }
+    return (int)(used * 1000 / (sample * EntriesPerBucket));
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Bitboard.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*
+    A transposition table shared by every search thread.
+
+    The table is an array of 64-byte buckets, one cache line each, holding
+    four 16-byte entries. The first three entries are depth-preferred: they
+    are only overwritten by a search at least as deep, or once the entry is
+    left over from an earlier search. The fourth always takes the newest
+    result, so recent positions are never lost. A position already in the
+    bucket is overwritten only by an exact score, a result at most two plies
+    shallower, or once it is from an earlier search; otherwise only its
+    move and age are refreshed.
+
+    There are no locks. An entry is two 64-bit words, the packed data and
+    the key XOR-ed with that data. A reader accepts an entry only if the
+    two words XOR back to its own key, so a torn write from another thread
+    (half old, half new) simply looks like a miss.
+*/
+
+enum BoundType : uint8_t
+{
+    BoundNone  = 0,
+    BoundUpper = 1,     // Score is at most this (failed low)
+    BoundLower = 2,     // Score is at least this (failed high)
+    BoundExact = 3
+};
+
+// What a successful probe hands back.
+struct TTData
+{
+    BitMove  move;
+    int16_t  score;
+    int8_t   depth;
+    uint8_t  bound;
+};
+
+class TranspositionTable
+{
+public:
+    explicit TranspositionTable(size_t megabytes = DefaultSizeMB);
+
+    static constexpr size_t DefaultSizeMB = 16;
+
+    // Reallocate to the largest power-of-two bucket count that fits, and clear.
+    void resize(size_t megabytes);
+    void clear();
+
+    // Start of a new search: entries from older searches become replaceable.
+    void newSearch() { _age = (_age + 1) & AgeMask; }
+
+    bool probe(uint64_t key, TTData& data) const;
+    void store(uint64_t key, BitMove move, int score, int depth, BoundType bound);
+
+    // Pull the key's bucket into cache ahead of the probe
+    void prefetch(uint64_t key) const
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(&_buckets[key & _mask]);
+#endif
+    }
+
+    // Used entries per thousand, sampled from the first buckets (UCI "hashfull")
+    int hashfull() const;
+
+    size_t sizeMB() const { return _megabytes; }
+
+private:
+    static constexpr int     EntriesPerBucket = 4;
+    static constexpr uint8_t AgeMask = 63;
+    static constexpr int     SameKeyDepthMargin = 2;   // How much shallower a same-key store may be and still replace
+
+    struct Entry
+    {
+        std::atomic<uint64_t> keyXorData;
+        std::atomic<uint64_t> data;
+    };
+
+    struct alignas(64) Bucket
+    {
+        Entry entries[EntriesPerBucket];
+    };
+
+    static_assert(sizeof(Bucket) == 64, "a bucket must fill exactly one cache line");
+
+    // data layout: move (16) | score (16) | depth (8) | bound (2) + age (6) (8)
+    static uint64_t Pack(BitMove move, int score, int depth, BoundType bound, uint8_t age)
+    {
+        return (uint64_t)move.getData()
+             | ((uint64_t)(uint16_t)score << 16)
+             | ((uint64_t)(uint8_t)depth << 32)
+             | ((uint64_t)(bound | (age << 2)) << 40);
+    }
+
+    static BitMove  MoveOf(uint64_t data)  { return BitMove::fromData((uint16_t)data); }
+    static int      ScoreOf(uint64_t data) { return (int16_t)(data >> 16); }
+    static int      DepthOf(uint64_t data) { return (int8_t)(data >> 32); }
+    static int      BoundOf(uint64_t data) { return (data >> 40) & 3; }
+    static uint8_t  AgeOf(uint64_t data)   { return (data >> 42) & AgeMask; }
+
+    std::unique_ptr<Bucket[]> _buckets;
+    uint64_t _mask;
+    size_t   _megabytes;
+    uint8_t  _age;
+};
@@ -1,5 +1,6 @@
 #pragma once
-#include <iostream>
+#include <cstdint>
+#include <cstring>
 
 class Game;
 class Player;
@@ -11,23 +12,35 @@ typedef enum {
 	kTurnFinished           // Turn is confirmed and finished
 } TurnStatus;
 
-class Turn
+//
+// the board after a turn, 4 bits per square for up to 64 squares (32 bytes)
+// each game decides what the 16 codes mean; 0 is always an empty square
+//
+struct BoardSnapshot
 {
-public:
-	Turn() : _game(nullptr), _player(nullptr), _status(kTurnEmpty), _move(""), _boardState(""), _date(0), _comment(""), _score(0), _replaying(false), _gameNumber(-1) {};
-	~Turn() {};
+	static constexpr int MaxSquares = 64;
 
-	static	Turn *initStartOfGame(Game *game) { Turn *turn = new Turn(); turn->_game = game; turn->_status = kTurnFinished; return turn; };
-	void	setStateString(std::string board) { _boardState = board; };
-	Game		*_game;
-	Player		*_player;
-	TurnStatus	_status;
-	std::string	_move;
-	std::string	_boardState;
-	int			_date;
-	std::string	_comment;
-	int			_score;
-	bool		_replaying;
-	int			_gameNumber;
+	uint8_t	packed[MaxSquares / 2];
+
+	void	clear() { std::memset(packed, 0, sizeof(packed)); }
+	int		get(int square) const { return (packed[square >> 1] >> ((square & 1) * 4)) & 0xF; }
+	void	set(int square, int code)
+	{
+		int shift = (square & 1) * 4;
+		packed[square >> 1] = (uint8_t)((packed[square >> 1] & ~(0xF << shift)) | ((code & 0xF) << shift));
+	}
 };
 
+//
+// one entry of the game history, stored by value in Game's turn arena
+//
+struct Turn
+{
+	BoardSnapshot	board;
+	uint32_t		move;           // game defined encoding of the move that was played, 0 for none
+	uint32_t		state;          // game defined extra state (chess: castling, en passant, halfmove clock)
+	int32_t			score;
+	uint16_t		number;         // currentTurnNo after this turn; 0 is the start position
+	int16_t			gameNumber;
+	uint8_t			squares;        // how many squares of board are in use
+};
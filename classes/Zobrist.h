@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Bitboard.h"
+
+#include <cstdint>
+
+/*
+    Zobrist hashing.
+
+    Every (piece, square) pair, the side to move, each of the 16 castling
+    right combinations and each en passant file gets a random 64-bit key.
+    A position's key is the XOR of the keys of everything in it, so a move
+    updates the key by XOR-ing out what left and XOR-ing in what arrived.
+
+    The tables are generated at compile time from a fixed seed, so keys
+    are the same on every run and usable before main() starts.
+*/
+
+struct ZobristTables
+{
+    uint64_t pieces[BLACK_KING + 1][64];     // Indexed by BitBoards piece board
+    uint64_t castling[16];
+    uint64_t enPassant[8];                   // By file
+    uint64_t side;                           // XOR-ed in when black is to move
+};
+
+// SplitMix64, a small generator with well mixed output.
+constexpr uint64_t ZobristNext(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristTables GenerateZobristTables()
+{
+    ZobristTables tables{};
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+
+    for (int board = 0; board <= BLACK_KING; board++)
+    {
+        for (int square = 0; square < 64; square++)
+        {
+            tables.pieces[board][square] = ZobristNext(state);
+        }
+    }
+    for (int rights = 0; rights < 16; rights++)
+    {
+        tables.castling[rights] = ZobristNext(state);
+    }
+    for (int file = 0; file < 8; file++)
+    {
+        tables.enPassant[file] = ZobristNext(state);
+    }
+    tables.side = ZobristNext(state);
+
+    return tables;
+}
+
+inline constexpr ZobristTables Zobrist = GenerateZobristTables();
@@ -0,0 +1,187 @@
+// Headless perft / divide benchmark for the chess engine.
+//
+// Usage:
+//   chess_perft                         run the built-in suite, checking every count
+//   chess_perft <depth> [fen]           perft one position (startpos by default)
+//   chess_perft --divide <depth> [fen]  per-root-move counts
+//   --full                              play every leaf move instead of bulk counting
+//
+// Exits non-zero if any suite count differs from the published value, or
+// if the arguments or the FEN can't be parsed.
+
+#include "classes/Perft.h"
+#include "classes/Position.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct PerftCase
+{
+    const char* name;
+    const char* fen;
+    std::vector<uint64_t> counts; // counts[d - 1] = perft(d)
+};
+
+// Standard positions from the Chess Programming Wiki perft results page
+static const std::vector<PerftCase> PerftSuite = {
+    { "startpos", StartingFEN,
+      { 20, 400, 8902, 197281, 4865609, 119060324 } },
+    { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      { 48, 2039, 97862, 4085603, 193690690 } },
+    { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+      { 14, 191, 2812, 43238, 674624, 11030083 } },
+    { "position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+      { 6, 264, 9467, 422333, 15833292 } },
+    { "position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+      { 44, 1486, 62379, 2103487, 89941194 } },
+    { "position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+      { 46, 2079, 89890, 3894594, 164075551 } },
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static uint64_t nodesPerSecond(uint64_t nodes, double seconds)
+{
+    return seconds > 0.0 ? (uint64_t)(nodes / seconds) : 0;
+}
+
+// A bad FEN (no kings, say) would crash the move generator, so stop here
+static Board boardFromFEN(const std::string& fen)
+{
+    Position position;
+    std::string error;
+    if (!position.setFromFEN(fen, &error))
+    {
+        std::cerr << "chess_perft: bad FEN \"" << fen << "\": " << error << std::endl;
+        std::exit(2);
+    }
+    return Board(position);
+}
+
+static int usage(const std::string& problem)
+{
+    std::cerr << "chess_perft: " << problem << "\n"
+              << "usage: chess_perft                         run the built-in suite\n"
+              << "       chess_perft <depth> [fen]           perft one position (startpos by default)\n"
+              << "       chess_perft --divide <depth> [fen]  per-root-move counts\n"
+              << "       --full                              play every leaf move instead of bulk counting\n";
+    return 2;
+}
+
+static bool runSuite(bool bulk)
+{
+    bool passed = true;
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0.0;
+
+    for (const PerftCase& test : PerftSuite)
+    {
+        Board board = boardFromFEN(test.fen);
+        std::cout << test.name << "  " << test.fen << "\n";
+
+        for (size_t depth = 1; depth <= test.counts.size(); depth++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            uint64_t nodes = Perft(board, (int)depth, bulk);
+            double seconds = secondsSince(start);
+
+            bool ok = nodes == test.counts[depth - 1];
+            passed = passed && ok;
+            totalNodes += nodes;
+            totalSeconds += seconds;
+
+            std::cout << "  depth " << depth
+                      << std::setw(12) << nodes << " nodes "
+                      << std::setw(9) << std::fixed << std::setprecision(3) << seconds << " s "
+                      << std::setw(12) << nodesPerSecond(nodes, seconds) << " nps"
+                      << (ok ? "" : "  MISMATCH, expected " + std::to_string(test.counts[depth - 1]))
+                      << "\n";
+        }
+    }
+
+    std::cout << "\nTotal " << totalNodes << " nodes in " << totalSeconds << " s ("
+              << nodesPerSecond(totalNodes, totalSeconds) << " nps) "
+              << (passed ? "PASS" : "FAIL") << std::endl;
+
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    MoveGenerator::PrecomputeMoveData();
+
+    bool bulk = true;
+    bool divide = false;
+    int depth = 0;
+    std::string fen;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool number = !arg.empty() && arg.find_first_not_of("0123456789") == std::string::npos;
+
+        if (arg == "--full") { bulk = false; }
+        else if (arg == "--divide") { divide = true; }
+        else if (arg.size() > 1 && arg[0] == '-') { return usage("unknown option " + arg); }
+        else if (depth == 0 && fen.empty() && number)
+        {
+            depth = std::atoi(arg.c_str());
+            if (depth < 1) { return usage("depth must be at least 1"); }
+        }
+        else if (fen.empty()) { fen = arg; }
+        else { return usage("unexpected argument \"" + arg + "\" (quote the FEN)"); }
+    }
+
+    if (depth == 0)
+    {
+        if (divide || !fen.empty())
+        {
+            return usage("a depth of at least 1 is needed before the FEN or with --divide");
+        }
+        return runSuite(bulk) ? 0 : 1;
+    }
+    if (fen.empty())
+    {
+        fen = StartingFEN;
+    }
+
+    Board board = boardFromFEN(fen);
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+
+    if (divide)
+    {
+        for (auto& [move, count] : Divide(board, depth, bulk))
+        {
+            std::cout << MoveToUCI(move) << ": " << count << "\n";
+            nodes += count;
+        }
+        std::cout << "\n";
+        seconds = secondsSince(start);
+    }
+    else
+    {
+        // Per-depth timings up to the requested depth
+        for (int d = 1; d <= depth; d++)
+        {
+            auto depthStart = std::chrono::steady_clock::now();
+            nodes = Perft(board, d, bulk);
+            seconds = secondsSince(depthStart);
+            std::cout << "depth " << d << std::setw(12) << nodes << " nodes "
+                      << std::setw(9) << std::fixed << std::setprecision(3) << seconds << " s "
+                      << std::setw(12) << nodesPerSecond(nodes, seconds) << " nps\n";
+        }
+    }
+
+    std::cout << "Nodes searched: " << nodes << "  (" << nodesPerSecond(nodes, seconds) << " nps)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,307 @@
+// Headless UCI engine: the chess engine without imgui or GLFW, speaking the
+// Universal Chess Interface on stdin / stdout.
+//
+// Supported: uci, isready, ucinewgame, setoption (Hash, Threads, EvalFile),
+// position [startpos | fen <fen>] [moves ...], go [depth | nodes | movetime |
+// wtime btime winc binc movestogo | infinite | ponder], stop, ponderhit, quit.
+//
+// The search runs on its own thread so stop, ponderhit and isready are
+// answered while it thinks.
+
+#include "classes/MoveGenerator.h"
+#include "classes/Nnue.h"
+#include "classes/ParallelSearch.h"
+#include "classes/Position.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char* EngineName = "chess";
+static const char* DefaultEvalFile = "resources/nnue.bin";
+
+class UciEngine
+{
+public:
+    UciEngine() : _search(_table, 1)
+    {
+        _position.setFromFEN(StartingFEN);
+        loadEvalFile(DefaultEvalFile, false);
+
+        _search.setIterationCallback([this](const SearchResult& result) { sendInfo(result); });
+    }
+
+    ~UciEngine() { stopSearch(); }
+
+    // Handle one command line; false once it was "quit".
+    bool command(const std::string& line)
+    {
+        std::istringstream in(line);
+        std::string token;
+        in >> token;
+
+        if (token == "uci")
+        {
+            send(std::string("id name ") + EngineName);
+            send("id author the chess project");
+            send("option name Hash type spin default " + std::to_string(TranspositionTable::DefaultSizeMB) + " min 1 max 65536");
+            send("option name Threads type spin default 1 min 1 max 256");
+            send(std::string("option name EvalFile type string default ") + DefaultEvalFile);
+            send("option name Ponder type check default false");
+            send("uciok");
+        }
+        else if (token == "isready")       { send("readyok"); }
+        else if (token == "ucinewgame")    { stopSearch(); _table.clear(); }
+        else if (token == "setoption")     { setOption(in); }
+        else if (token == "position")      { stopSearch(); setPosition(in); }
+        else if (token == "go")            { go(in); }
+        else if (token == "stop")          { stopSearch(); }
+        else if (token == "ponderhit")     { ponderhit(); }
+        else if (token == "quit")          { stopSearch(); return false; }
+        else if (!token.empty())           { send("info string unknown command " + token); }
+
+        return true;
+    }
+
+private:
+    void send(const std::string& text)
+    {
+        std::lock_guard<std::mutex> lock(_outputMutex);
+        std::cout << text << std::endl;
+    }
+
+    void sendInfo(const SearchResult& result)
+    {
+        int64_t elapsed = std::max<int64_t>(1, (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                     std::chrono::steady_clock::now() - _searchStart).count());
+
+        std::ostringstream info;
+        info << "info depth " << result.depth << " score ";
+        if (std::abs(result.score) >= MateBound)
+        {
+            int plies = MateScore - std::abs(result.score);
+            info << "mate " << (result.score > 0 ? (plies + 1) / 2 : -(plies / 2));
+        }
+        else
+        {
+            info << "cp " << result.score;
+        }
+        info << " nodes " << result.nodes << " nps " << result.nodes * 1000 / elapsed << " time " << elapsed
+             << " hashfull " << _table.hashfull() << " pv";
+        for (int i = 0; i < result.pvLength; i++)
+        {
+            info << " " << MoveToUCI(result.pv[i]);
+        }
+        send(info.str());
+    }
+
+    void loadEvalFile(const std::string& path, bool report)
+    {
+        bool loaded = LoadNetwork(path);
+        _search.setUseNnue(loaded);
+        if (report || loaded)
+        {
+            send("info string " + (loaded ? "using NNUE " + path + " (" + NnueKernelName() + ")"
+                                          : "no network at " + path + ", using the classical evaluation"));
+        }
+    }
+
+    // setoption name <id> [value <x>]; names and values may contain spaces
+    void setOption(std::istringstream& in)
+    {
+        std::string token, name, value;
+        std::string* field = nullptr;
+
+        while (in >> token)
+        {
+            if (token == "name")       { field = &name; }
+            else if (token == "value") { field = &value; }
+            else if (field)            { *field += (field->empty() ? "" : " ") + token; }
+        }
+
+        stopSearch();
+
+        if (name == "Hash")          { _table.resize((size_t)std::max(1, std::atoi(value.c_str()))); }
+        else if (name == "Threads")  { _search.setThreads(std::atoi(value.c_str())); }
+        else if (name == "EvalFile") { loadEvalFile(value, true); }
+        else if (name == "Ponder")   { }
+        else                         { send("info string unknown option " + name); }
+    }
+
+    // position [startpos | fen <fen>] [moves <move> ...]
+    void setPosition(std::istringstream& in)
+    {
+        std::string token, fen;
+        in >> token;
+
+        if (token == "startpos")
+        {
+            fen = StartingFEN;
+            in >> token;
+        }
+        else if (token == "fen")
+        {
+            while (in >> token && token != "moves")
+            {
+                fen += (fen.empty() ? "" : " ") + token;
+            }
+        }
+        else
+        {
+            send("info string expected startpos or fen");
+            return;
+        }
+
+        _gameKeys.clear();
+
+        std::string error;
+        if (!_position.setFromFEN(fen, &error))
+        {
+            send("info string bad fen: " + error);
+            _position.setFromFEN(StartingFEN);
+            return;
+        }
+
+        while (in >> token)
+        {
+            if (!playMove(token))
+            {
+                send("info string illegal move " + token);
+                break;
+            }
+        }
+    }
+
+    bool playMove(const std::string& text)
+    {
+        MoveList moves;
+        MoveGenerator generator(_position);
+        generator.GenerateAllMoves(moves);
+
+        for (const BitMove& move : moves)
+        {
+            if (MoveToUCI(move) == text)
+            {
+                UndoInfo undo;
+                _gameKeys.push_back(_position.zobristKey);
+                _position.makeMove(move, undo);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void go(std::istringstream& in)
+    {
+        stopSearch();
+
+        SearchLimits limits;
+        bool infinite = false;
+        std::string token;
+
+        while (in >> token)
+        {
+            if (token == "depth")          { in >> limits.depth; }
+            else if (token == "nodes")     { in >> limits.nodes; }
+            else if (token == "movetime")  { in >> limits.moveTime; }
+            else if (token == "wtime")     { in >> limits.time[White]; }
+            else if (token == "btime")     { in >> limits.time[Black]; }
+            else if (token == "winc")      { in >> limits.increment[White]; }
+            else if (token == "binc")      { in >> limits.increment[Black]; }
+            else if (token == "movestogo") { in >> limits.movesToGo; }
+            else if (token == "infinite")  { infinite = true; }
+            else if (token == "ponder")    { limits.ponder = true; }
+        }
+
+        // Until stop (or ponderhit) bestmove has to wait, even if the search
+        // itself has nothing left to do
+        {
+            std::lock_guard<std::mutex> lock(_stateMutex);
+            _holdBestMove = infinite || limits.ponder;
+        }
+
+        _search.setGameHistory(_gameKeys);
+        _searchStart = std::chrono::steady_clock::now();
+        std::future<SearchResult> search = _search.thinkAsync(_position, limits);
+
+        _thread = std::thread([this, search = std::move(search)]() mutable {
+            SearchResult result = search.get();
+
+            std::unique_lock<std::mutex> lock(_stateMutex);
+            _released.wait(lock, [this]() { return !_holdBestMove; });
+            lock.unlock();
+
+            // Totals over all threads, so the effect of each pruning rule can be measured
+            send("info string pruning " + PruningSummary(result.pruning));
+
+            std::string bestMove = "bestmove " + (result.bestMove.isNull() ? std::string("0000") : MoveToUCI(result.bestMove));
+            if (result.pvLength > 1)
+            {
+                bestMove += " ponder " + MoveToUCI(result.pv[1]);
+            }
+            send(bestMove);
+        });
+    }
+
+    // Let bestmove out and wait for the search thread to send it
+    void stopSearch()
+    {
+        if (!_thread.joinable())
+        {
+            return;
+        }
+
+        releaseBestMove();
+        _search.stop();
+        _thread.join();
+    }
+
+    void ponderhit()
+    {
+        _search.ponderhit();
+        releaseBestMove();
+    }
+
+    void releaseBestMove()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_stateMutex);
+            _holdBestMove = false;
+        }
+        _released.notify_all();
+    }
+
+    TranspositionTable _table;
+    ParallelSearch     _search;
+    Position           _position;
+    std::vector<uint64_t> _gameKeys;    // Positions before _position, for repetition draws
+
+    std::thread        _thread;
+    std::chrono::steady_clock::time_point _searchStart;
+
+    std::mutex         _outputMutex;
+    std::mutex         _stateMutex;
+    std::condition_variable _released;
+    bool               _holdBestMove = false;
+};
+
+int main()
+{
+    MoveGenerator::PrecomputeMoveData();
+
+    UciEngine engine;
+    std::string line;
+
+    while (std::getline(std::cin, line) && engine.command(line))
+    {
+    }
+
+    return 0;
+}